@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+#include "Cpu.h"
+#include "Float.h"
+#include "FloatColumn.h"
+#include "FloatDecode.h"
+#include "FloatEncode.h"
+#include "FloatOps.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/// Every measurement repeats the kernel until it ran at least this long.
+	const double MIN_MEASURE_SECONDS = 0.2;
+	/// Fixed, so every run measures the same inputs.
+	const std::uint64_t BENCHMARK_SEED = 20240601;
+
+	struct NamedRun
+	{
+		std::string Name;
+		/// Bytes read and written per element.
+		unsigned BytesPerElement;
+		std::function<void(std::size_t length)> Run;
+	};
+
+	/// Decodes from the fields instead of the table, what every conversion cost before the table existed.
+	void DecodeFloatsFromFields(const std::uint8_t* packed, float* values, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const Float number(static_cast<char>(packed[i]));
+			values[i] = number.sign() * number.mantissa() * std::ldexp(1.f, number.actual_exponent());
+		}
+	}
+
+	double MeasureThroughput(const NamedRun& run, std::size_t length)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		unsigned runs = 0;
+		const Clock::time_point start = Clock::now();
+		double elapsed = 0.0;
+
+		do
+		{
+			run.Run(length);
+			++runs;
+			elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		} while (elapsed < MIN_MEASURE_SECONDS);
+
+		return static_cast<double>(length) * run.BytesPerElement * runs / elapsed * 1e-9;
+	}
+}
+
+void RunCodecBenchmark()
+{
+	const std::size_t lengths[] = { 1000, 100000, 10000000 };
+	const std::size_t maxLength = lengths[sizeof(lengths) / sizeof(lengths[0]) - 1];
+
+	/// Values spread over the whole Float range, with both signs.
+	std::vector<float> values(maxLength);
+	std::vector<std::uint8_t> packed(maxLength);
+	std::vector<std::uint8_t> other(maxLength);
+	std::vector<float> decoded(maxLength);
+
+	const FloatDetail::StochasticKey key = FloatDetail::MakeStochasticKey(BENCHMARK_SEED);
+	for (std::size_t i = 0; i < maxLength; ++i)
+	{
+		packed[i] = static_cast<std::uint8_t>(FloatDetail::StochasticBits(i, key));
+		other[i] = static_cast<std::uint8_t>(FloatDetail::StochasticBits(i, key) >> 8);
+		values[i] = float(Float(static_cast<char>(packed[i]))) * 1.01f;
+	}
+
+	std::vector<NamedRun> runs;
+
+	const std::uint8_t* const input = packed.data();
+	float* const output = decoded.data();
+	runs.push_back({ "decode fields", 5, [=](std::size_t length) { DecodeFloatsFromFields(input, output, length); } });
+	runs.push_back({ "decode table", 5, [=](std::size_t length) { DecodeFloatsScalar(input, output, length); } });
+	if (Cpu::Features() & Cpu::SSSE3)
+	{
+		runs.push_back({ "decode SSSE3", 5, [=](std::size_t length) { DecodeFloatsSsse3(input, output, length); } });
+	}
+	if (Cpu::Features() & Cpu::AVX2)
+	{
+		runs.push_back({ "decode AVX2", 5, [=](std::size_t length) { DecodeFloatsAvx2(input, output, length); } });
+	}
+
+	std::vector<std::pair<const char*, EncodeKernel>> encoders = { { "scalar", EncodeFloatsScalar } };
+	if (Cpu::Features() & Cpu::SSE41)
+	{
+		encoders.push_back({ "SSE4.1", EncodeFloatsSse41 });
+	}
+	if (Cpu::Features() & Cpu::AVX2)
+	{
+		encoders.push_back({ "AVX2", EncodeFloatsAvx2 });
+	}
+
+	const float* const source = values.data();
+	std::uint8_t* const destination = other.data();
+	for (int mode = 0; mode < 2; ++mode)
+	{
+		for (std::size_t e = 0; e < encoders.size(); ++e)
+		{
+			const RoundingMode rounding = mode == 0 ? RoundingMode::Nearest : RoundingMode::Stochastic;
+			const EncodeKernel kernel = encoders[e].second;
+			const std::string name = std::string("encode ") + (mode == 0 ? "nearest " : "stochastic ") + encoders[e].first;
+
+			runs.push_back({ name, 5, [=](std::size_t length) { kernel(source, destination, length, rounding, BENCHMARK_SEED); } });
+		}
+	}
+
+	std::vector<std::uint8_t> result(maxLength);
+	std::uint8_t* const product = result.data();
+	const std::uint8_t* const rhs = other.data();
+	runs.push_back({ "multiply table", 3, [=](std::size_t length) { FloatOps::Apply(FloatOps::Operation::Multiply, input, rhs, product, length); } });
+
+	/// Only the Float bytes are read, the floats never leave the registers.
+	volatile double sink = 0.0;
+	runs.push_back({ "column sum table", 1, [=, &sink](std::size_t length) { sink = sink + SumPackedFloatsScalar(input, length); } });
+	if (Cpu::Features() & Cpu::SSSE3)
+	{
+		runs.push_back({ "column sum SSSE3", 1, [=, &sink](std::size_t length) { sink = sink + SumPackedFloatsSsse3(input, length); } });
+	}
+	if (Cpu::Features() & Cpu::AVX2)
+	{
+		runs.push_back({ "column sum AVX2", 1, [=, &sink](std::size_t length) { sink = sink + SumPackedFloatsAvx2(input, length); } });
+	}
+
+	std::printf("%-26s %10s %10s %12s\n", "kernel", "length", "GB/s", "Melements/s");
+
+	for (std::size_t length : lengths)
+	{
+		for (const NamedRun& run : runs)
+		{
+			const double throughput = MeasureThroughput(run, length);
+			std::printf("%-26s %10zu %10.2f %12.1f\n", run.Name.c_str(), length, throughput, throughput * 1e3 / run.BytesPerElement);
+		}
+	}
+}
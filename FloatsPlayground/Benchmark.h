@@ -0,0 +1,5 @@
+#pragma once
+
+/// Times the decode and encode kernels, the table operations and the column sum over several lengths
+/// and prints the throughput in GB/s, counting the Float bytes and the float bytes moved.
+void RunCodecBenchmark();
@@ -0,0 +1,90 @@
+#include "Cpu.h"
+
+#if CPU_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+#if CPU_X86
+	void Cpuid(unsigned leaf, unsigned subleaf, unsigned (&registers)[4])
+	{
+#if defined(_MSC_VER)
+		int values[4];
+		__cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+
+		for (int i = 0; i < 4; ++i)
+		{
+			registers[i] = static_cast<unsigned>(values[i]);
+		}
+#else
+		registers[0] = registers[1] = registers[2] = registers[3] = 0;
+		__get_cpuid_count(leaf, subleaf, &registers[0], &registers[1], &registers[2], &registers[3]);
+#endif
+	}
+
+	unsigned long long ReadXcr0()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned eax = 0;
+		unsigned edx = 0;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+	}
+
+	unsigned DetectFeatures()
+	{
+		unsigned features = 0;
+		unsigned registers[4];
+
+		Cpuid(0, 0, registers);
+		const unsigned maxLeaf = registers[0];
+
+		Cpuid(1, 0, registers);
+		if (registers[2] & (1u << 9))
+		{
+			features |= Cpu::SSSE3;
+		}
+
+		if (registers[2] & (1u << 19))
+		{
+			features |= Cpu::SSE41;
+		}
+
+		const bool osxsave = (registers[2] & (1u << 27)) != 0;
+		if (!osxsave || maxLeaf < 7)
+		{
+			return features;
+		}
+
+		/// XMM and YMM state
+		const bool ymmEnabled = (ReadXcr0() & 0x6) == 0x6;
+
+		Cpuid(7, 0, registers);
+		if (ymmEnabled && (registers[1] & (1u << 5)))
+		{
+			features |= Cpu::AVX2;
+		}
+
+		return features;
+	}
+#else
+	unsigned DetectFeatures()
+	{
+		return 0;
+	}
+#endif
+}
+
+unsigned Cpu::Features()
+{
+	static const unsigned features = DetectFeatures();
+	return features;
+}
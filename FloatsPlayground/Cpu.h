@@ -0,0 +1,33 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86 1
+#else
+#define CPU_X86 0
+#endif
+
+/// GCC and Clang only emit wide instructions in functions marked for them, MSVC needs no marker.
+#if CPU_X86 && defined(__GNUC__)
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSSE3
+#define TARGET_SSE41
+#define TARGET_AVX2
+#endif
+
+/// Instruction sets usable on the running machine, checked through cpuid and,
+/// for the wide registers, through xgetbv so that the OS also saves them.
+namespace Cpu
+{
+	enum Feature : unsigned
+	{
+		SSSE3 = 1u << 0,
+		SSE41 = 1u << 1,
+		AVX2 = 1u << 2,
+	};
+
+	/// Bitmask of Feature values, detected on the first call.
+	unsigned Features();
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace FloatDetail
+{
+	struct DecodeTable
+	{
+		float Values[256];
+	};
+
+	/// Value of a bit pattern built without any float bit tricks, so it can run at compile time.
+	constexpr float Decode(unsigned bits)
+	{
+		float value = static_cast<float>(16 + (bits & 0xFu)) / 16.f;
+		const int exponent = static_cast<int>((bits >> 4) & 0x7u) - 3;
+
+		for (int i = 0; i < exponent; ++i)
+		{
+			value *= 2.f;
+		}
+
+		for (int i = exponent; i < 0; ++i)
+		{
+			value /= 2.f;
+		}
+
+		return (bits & 0x80u) ? -value : value;
+	}
+
+	constexpr DecodeTable MakeDecodeTable()
+	{
+		DecodeTable table{};
+
+		for (unsigned bits = 0; bits < 256; ++bits)
+		{
+			table.Values[bits] = Decode(bits);
+		}
+
+		return table;
+	}
+
+	/// Every Float value, indexed by its bit pattern.
+	constexpr DecodeTable DECODE_TABLE = MakeDecodeTable();
+
+	struct RankTable
+	{
+		std::uint8_t Ranks[256];
+	};
+
+	/// Position of every pattern in value order. Every pattern has its own value, there is not even
+	/// a signed zero, so patterns compare like their ranks.
+	constexpr RankTable MakeRankTable()
+	{
+		RankTable table{};
+
+		for (unsigned bits = 0; bits < 256; ++bits)
+		{
+			table.Ranks[bits] = static_cast<std::uint8_t>(bits & 0x80u ? 0xFFu - bits : 0x80u + bits);
+		}
+
+		return table;
+	}
+
+	constexpr RankTable RANK_TABLE = MakeRankTable();
+
+	/// Rounding increment for round to nearest, ties to even, of float bits to a Float.
+	inline std::uint32_t NearestIncrement(std::uint32_t bits)
+	{
+		return 0x3FFFFu + ((bits >> 19) & 1u);
+	}
+
+	/// Encodes float bits to a Float, the increment is added to the 19 mantissa bits that are dropped.
+	/// A float with exponent e and mantissa m has the Float exponent e - 124 and mantissa m >> 19,
+	/// so after rounding, the Float pattern is the float magnitude shifted right by 19, minus 124 << 4.
+	/// Magnitudes below 0.125 give the smallest magnitude, as there is no zero, and everything
+	/// above 31 saturates to 31, infinities and NaNs included. The sign is always kept.
+	inline std::uint8_t EncodeBits(std::uint32_t bits, std::uint32_t increment)
+	{
+		const std::uint32_t sign = (bits >> 24) & 0x80u;
+		const std::int32_t code = static_cast<std::int32_t>(((bits & 0x7FFFFFFFu) + increment) >> 19) - (124 << 4);
+
+		const std::int32_t clamped = code < 0 ? 0 : (code > 0x7F ? 0x7F : code);
+		return static_cast<std::uint8_t>(sign | static_cast<std::uint32_t>(clamped));
+	}
+}
+
+/// 8 bit float: 1 sign bit, 3 exponent bits with bias 3 and 4 mantissa bits.
+/// There are no subnormals, every pattern has the implicit leading 1, so magnitudes run
+/// from 0.125 to 31 and there is no zero.
+class Float
+{
+public:
+	Float() : m_Buffer(0) { }
+	/// Explicit, with the implicit conversion to float both ways would make Float + float ambiguous.
+	explicit Float(char number) : m_Buffer(number) { }
+
+	/// Nearest Float to value, ties to even, see FloatDetail::EncodeBits for the values out of range.
+	static Float from_float(float value)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		return Float(static_cast<char>(FloatDetail::EncodeBits(bits, FloatDetail::NearestIncrement(bits))));
+	}
+
+	operator float() const
+	{
+		return FloatDetail::DECODE_TABLE.Values[bits()];
+	}
+
+	std::uint8_t bits() const
+	{
+		return static_cast<std::uint8_t>(m_Buffer);
+	}
+
+	int sign() const
+	{
+		return m_Buffer & (1u << 7) ? -1 : 1;
+	}
+
+	unsigned biased_exponent() const
+	{
+		return (m_Buffer & 0x70u) >> 4;
+	}
+
+	int actual_exponent() const
+	{
+		return biased_exponent() - 3;
+	}
+
+	float mantissa() const
+	{
+		return 1.f + static_cast<float>(m_Buffer & 0x0Fu) / 16.f;
+	}
+
+private:
+	char m_Buffer;
+};
+
+static_assert(sizeof(Float) == 1, "Float arrays are read as packed bytes");
+
+inline bool operator==(Float lhs, Float rhs)
+{
+	return lhs.bits() == rhs.bits();
+}
+
+inline bool operator!=(Float lhs, Float rhs)
+{
+	return lhs.bits() != rhs.bits();
+}
+
+inline bool operator<(Float lhs, Float rhs)
+{
+	return FloatDetail::RANK_TABLE.Ranks[lhs.bits()] < FloatDetail::RANK_TABLE.Ranks[rhs.bits()];
+}
+
+inline bool operator>(Float lhs, Float rhs)
+{
+	return rhs < lhs;
+}
+
+inline bool operator<=(Float lhs, Float rhs)
+{
+	return !(rhs < lhs);
+}
+
+inline bool operator>=(Float lhs, Float rhs)
+{
+	return !(lhs < rhs);
+}
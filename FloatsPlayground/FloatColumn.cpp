@@ -0,0 +1,279 @@
+#include "FloatColumn.h"
+#include "Cpu.h"
+#include "Float.h"
+#include "FloatDecode.h"
+#include "FloatDecodeSimd.h"
+
+#include <cmath>
+
+namespace
+{
+	/// Elements summed by a kernel call before the block result moves into double.
+	/// Keeps the float lanes far from magnitudes where their ULP gets coarse.
+	const std::size_t BLOCK_LENGTH = 1 << 16;
+	/// Elements decoded at once while appending.
+	const std::size_t CHUNK_LENGTH = 1024;
+	const int ACCUMULATORS = 4;
+
+	/// Running Kahan state of one lane, the value is sum - compensator.
+	struct KahanLane
+	{
+		float Sum;
+		float Compensator;
+	};
+
+	void KahanAdd(KahanLane& lane, float value)
+	{
+		const float compensatedNumber = value - lane.Compensator;
+		const float temporarySum = lane.Sum + compensatedNumber;
+
+		lane.Compensator = (temporarySum - lane.Sum) - compensatedNumber;
+		lane.Sum = temporarySum;
+	}
+
+	double KahanAddDouble(double& sum, double& compensator, double value)
+	{
+		const double compensatedNumber = value - compensator;
+		const double temporarySum = sum + compensatedNumber;
+
+		compensator = (temporarySum - sum) - compensatedNumber;
+		sum = temporarySum;
+		return sum;
+	}
+
+	/// Adds the lanes up in double, their values are far smaller than a block of doubles could lose.
+	double ReduceLanes(const float* sums, const float* compensators, std::size_t lanes)
+	{
+		double total = 0.0;
+
+		for (std::size_t i = 0; i < lanes; ++i)
+		{
+			total += static_cast<double>(sums[i]) - static_cast<double>(compensators[i]);
+		}
+
+		return total;
+	}
+
+	double SumBlockScalar(const std::uint8_t* packed, std::size_t count)
+	{
+		KahanLane lane = { 0.f, 0.f };
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			KahanAdd(lane, FloatDetail::DECODE_TABLE.Values[packed[i]]);
+		}
+
+		return static_cast<double>(lane.Sum) - static_cast<double>(lane.Compensator);
+	}
+
+#if CPU_X86
+	TARGET_SSSE3 double SumBlockSsse3(const std::uint8_t* packed, std::size_t count)
+	{
+		__m128 sum[ACCUMULATORS];
+		__m128 compensator[ACCUMULATORS];
+
+		for (int k = 0; k < ACCUMULATORS; ++k)
+		{
+			sum[k] = _mm_setzero_ps();
+			compensator[k] = _mm_setzero_ps();
+		}
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128 floats[ACCUMULATORS];
+			FloatDecodeSimd::Decode(_mm_loadu_si128(reinterpret_cast<const __m128i*>(packed + i)), floats);
+
+			for (int k = 0; k < ACCUMULATORS; ++k)
+			{
+				const __m128 compensatedNumber = _mm_sub_ps(floats[k], compensator[k]);
+				const __m128 temporarySum = _mm_add_ps(sum[k], compensatedNumber);
+
+				compensator[k] = _mm_sub_ps(_mm_sub_ps(temporarySum, sum[k]), compensatedNumber);
+				sum[k] = temporarySum;
+			}
+		}
+
+		float sums[4 * ACCUMULATORS];
+		float compensators[4 * ACCUMULATORS];
+		for (int k = 0; k < ACCUMULATORS; ++k)
+		{
+			_mm_storeu_ps(sums + 4 * k, sum[k]);
+			_mm_storeu_ps(compensators + 4 * k, compensator[k]);
+		}
+
+		return ReduceLanes(sums, compensators, 4 * ACCUMULATORS) + SumBlockScalar(packed + i, count - i);
+	}
+
+	TARGET_AVX2 double SumBlockAvx2(const std::uint8_t* packed, std::size_t count)
+	{
+		__m256 sum[ACCUMULATORS];
+		__m256 compensator[ACCUMULATORS];
+
+		for (int k = 0; k < ACCUMULATORS; ++k)
+		{
+			sum[k] = _mm256_setzero_ps();
+			compensator[k] = _mm256_setzero_ps();
+		}
+
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			__m256 floats[ACCUMULATORS];
+			FloatDecodeSimd::Decode(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(packed + i)), floats);
+
+			for (int k = 0; k < ACCUMULATORS; ++k)
+			{
+				const __m256 compensatedNumber = _mm256_sub_ps(floats[k], compensator[k]);
+				const __m256 temporarySum = _mm256_add_ps(sum[k], compensatedNumber);
+
+				compensator[k] = _mm256_sub_ps(_mm256_sub_ps(temporarySum, sum[k]), compensatedNumber);
+				sum[k] = temporarySum;
+			}
+		}
+
+		float sums[8 * ACCUMULATORS];
+		float compensators[8 * ACCUMULATORS];
+		for (int k = 0; k < ACCUMULATORS; ++k)
+		{
+			_mm256_storeu_ps(sums + 8 * k, sum[k]);
+			_mm256_storeu_ps(compensators + 8 * k, compensator[k]);
+		}
+
+		return ReduceLanes(sums, compensators, 8 * ACCUMULATORS) + SumBlockScalar(packed + i, count - i);
+	}
+#endif
+
+	/// Blocks are merged with Kahan in double as well.
+	double SumBlocks(double (*sumBlock)(const std::uint8_t*, std::size_t), const std::uint8_t* packed, std::size_t count)
+	{
+		double sum = 0.0;
+		double compensator = 0.0;
+
+		for (std::size_t i = 0; i < count; i += BLOCK_LENGTH)
+		{
+			const std::size_t length = count - i < BLOCK_LENGTH ? count - i : BLOCK_LENGTH;
+			KahanAddDouble(sum, compensator, sumBlock(packed + i, length));
+		}
+
+		return sum - compensator;
+	}
+}
+
+double SumPackedFloatsScalar(const std::uint8_t* packed, std::size_t count)
+{
+	return SumBlocks(SumBlockScalar, packed, count);
+}
+
+double SumPackedFloatsSsse3(const std::uint8_t* packed, std::size_t count)
+{
+#if CPU_X86
+	return SumBlocks(SumBlockSsse3, packed, count);
+#else
+	return SumPackedFloatsScalar(packed, count);
+#endif
+}
+
+double SumPackedFloatsAvx2(const std::uint8_t* packed, std::size_t count)
+{
+#if CPU_X86
+	return SumBlocks(SumBlockAvx2, packed, count);
+#else
+	return SumPackedFloatsScalar(packed, count);
+#endif
+}
+
+PackedSumKernel SelectPackedSumKernel()
+{
+	const unsigned features = Cpu::Features();
+
+	if (features & Cpu::AVX2)
+	{
+		return SumPackedFloatsAvx2;
+	}
+
+	if (features & Cpu::SSSE3)
+	{
+		return SumPackedFloatsSsse3;
+	}
+
+	return SumPackedFloatsScalar;
+}
+
+const char* PackedSumKernelName(PackedSumKernel kernel)
+{
+	if (kernel == SumPackedFloatsAvx2)
+	{
+		return "AVX2";
+	}
+
+	if (kernel == SumPackedFloatsSsse3)
+	{
+		return "SSSE3";
+	}
+
+	return "scalar";
+}
+
+FloatColumn::FloatColumn(RoundingMode mode, std::uint64_t seed)
+	: m_Mode(mode)
+	, m_Seed(seed)
+	, m_QuantizationError(0.0)
+	, m_QuantizationCompensator(0.0)
+	, m_AbsoluteSum(0.0)
+{
+}
+
+void FloatColumn::Append(const float* values, std::size_t count)
+{
+	const std::size_t first = m_Packed.size();
+	m_Packed.resize(first + count);
+
+	/// Every append draws from its own stream, keyed by where it starts.
+	EncodeFloats(values, m_Packed.data() + first, count, m_Mode, m_Seed + first);
+
+	float decoded[CHUNK_LENGTH];
+	for (std::size_t i = 0; i < count; i += CHUNK_LENGTH)
+	{
+		const std::size_t length = count - i < CHUNK_LENGTH ? count - i : CHUNK_LENGTH;
+		DecodeFloats(m_Packed.data() + first + i, decoded, length);
+
+		for (std::size_t k = 0; k < length; ++k)
+		{
+			/// Exact in double for magnitudes from 2^-32 to 2^46, the Float range and far beyond it: decoded values
+			/// are multiples of 2^-7 below 32, so the difference needs at most 53 bits. Outside of that it is rounded once.
+			KahanAddDouble(m_QuantizationError, m_QuantizationCompensator, static_cast<double>(values[i + k]) - decoded[k]);
+			m_AbsoluteSum += std::fabs(decoded[k]);
+		}
+	}
+}
+
+std::size_t FloatColumn::Size() const
+{
+	return m_Packed.size();
+}
+
+const std::uint8_t* FloatColumn::Data() const
+{
+	return m_Packed.data();
+}
+
+void FloatColumn::Decode(std::size_t first, std::size_t count, float* values) const
+{
+	DecodeFloats(m_Packed.data() + first, values, count);
+}
+
+ColumnSum FloatColumn::Sum() const
+{
+	/// Kahan summation in float errs by at most 2u + O(n u^2) times the sum of magnitudes, u = 2^-24.
+	/// The lanes and blocks are merged in double, their part is covered by the last term.
+	const double u = std::ldexp(1.0, -24);
+	const double laneLength = static_cast<double>(BLOCK_LENGTH);
+
+	ColumnSum result;
+	result.Sum = SelectPackedSumKernel()(m_Packed.data(), m_Packed.size());
+	result.QuantizationError = m_QuantizationError - m_QuantizationCompensator;
+	result.SummationErrorBound = (2.0 * u + laneLength * u * u + std::ldexp(1.0, -50)) * m_AbsoluteSum;
+
+	return result;
+}
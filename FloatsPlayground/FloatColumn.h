@@ -0,0 +1,60 @@
+#pragma once
+
+#include "FloatEncode.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ColumnSum
+{
+	/// Sum of the stored values.
+	double Sum;
+	/// Sum of original minus stored value over everything appended, so Sum + QuantizationError
+	/// estimates the sum of the original floats. Each difference is exact for magnitudes from 2^-32
+	/// to 2^46, far saturated values and smaller ones, denormals included, add their rounding error.
+	double QuantizationError;
+	/// Bound on the difference between Sum and the exact sum of the stored values.
+	double SummationErrorBound;
+};
+
+/// Floats stored as packed Floats, a quarter of the memory of the float32 column.
+/// Summing decodes 32 bytes at a time in vector registers and feeds them straight into Kahan
+/// accumulators, so the floats never go through memory. The error from rounding to Float
+/// is measured once while appending, which makes it part of every ColumnSum.
+class FloatColumn
+{
+public:
+	explicit FloatColumn(RoundingMode mode = RoundingMode::Nearest, std::uint64_t seed = 0);
+
+	/// Values outside of the Float range saturate, see FloatDetail::EncodeBits.
+	/// Stochastic rounding is reproducible for the same sequence of appends.
+	void Append(const float* values, std::size_t count);
+
+	std::size_t Size() const;
+	const std::uint8_t* Data() const;
+
+	void Decode(std::size_t first, std::size_t count, float* values) const;
+	ColumnSum Sum() const;
+
+private:
+	std::vector<std::uint8_t> m_Packed;
+	RoundingMode m_Mode;
+	std::uint64_t m_Seed;
+
+	/// Kahan sums in double, kept while appending.
+	double m_QuantizationError;
+	double m_QuantizationCompensator;
+	/// Exact, every Float is a multiple of 2^-7 below 32.
+	double m_AbsoluteSum;
+};
+
+/// Kahan sum of packed Floats, decoded on the fly. Lanes are summed in float and merged in double.
+typedef double (*PackedSumKernel)(const std::uint8_t* packed, std::size_t count);
+
+double SumPackedFloatsScalar(const std::uint8_t* packed, std::size_t count);
+double SumPackedFloatsSsse3(const std::uint8_t* packed, std::size_t count);
+double SumPackedFloatsAvx2(const std::uint8_t* packed, std::size_t count);
+
+PackedSumKernel SelectPackedSumKernel();
+const char* PackedSumKernelName(PackedSumKernel kernel);
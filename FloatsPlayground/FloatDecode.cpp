@@ -0,0 +1,86 @@
+#include "FloatDecode.h"
+#include "Cpu.h"
+#include "Float.h"
+#include "FloatDecodeSimd.h"
+
+void DecodeFloatsScalar(const std::uint8_t* packed, float* values, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		values[i] = FloatDetail::DECODE_TABLE.Values[packed[i]];
+	}
+}
+
+TARGET_SSSE3 void DecodeFloatsSsse3(const std::uint8_t* packed, float* values, std::size_t count)
+{
+#if CPU_X86
+	std::size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128 floats[4];
+		FloatDecodeSimd::Decode(_mm_loadu_si128(reinterpret_cast<const __m128i*>(packed + i)), floats);
+
+		for (int k = 0; k < 4; ++k)
+		{
+			_mm_storeu_ps(values + i + 4 * k, floats[k]);
+		}
+	}
+
+	DecodeFloatsScalar(packed + i, values + i, count - i);
+#else
+	DecodeFloatsScalar(packed, values, count);
+#endif
+}
+
+TARGET_AVX2 void DecodeFloatsAvx2(const std::uint8_t* packed, float* values, std::size_t count)
+{
+#if CPU_X86
+	std::size_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256 floats[4];
+		FloatDecodeSimd::Decode(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(packed + i)), floats);
+
+		for (int k = 0; k < 4; ++k)
+		{
+			_mm256_storeu_ps(values + i + 8 * k, floats[k]);
+		}
+	}
+
+	DecodeFloatsScalar(packed + i, values + i, count - i);
+#else
+	DecodeFloatsScalar(packed, values, count);
+#endif
+}
+
+DecodeKernel SelectDecodeKernel()
+{
+	const unsigned features = Cpu::Features();
+
+	if (features & Cpu::AVX2)
+	{
+		return DecodeFloatsAvx2;
+	}
+
+	if (features & Cpu::SSSE3)
+	{
+		return DecodeFloatsSsse3;
+	}
+
+	return DecodeFloatsScalar;
+}
+
+const char* DecodeKernelName(DecodeKernel kernel)
+{
+	if (kernel == DecodeFloatsAvx2)
+	{
+		return "AVX2";
+	}
+
+	if (kernel == DecodeFloatsSsse3)
+	{
+		return "SSSE3";
+	}
+
+	return "scalar";
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Converts count packed Float bit patterns to float.
+typedef void (*DecodeKernel)(const std::uint8_t* packed, float* values, std::size_t count);
+
+/// Looks every byte up in the Float decode table.
+void DecodeFloatsScalar(const std::uint8_t* packed, float* values, std::size_t count);
+
+/// Builds the float bits directly, 16 / 32 bytes at a time.
+/// The upper byte of a float only depends on the sign and exponent, the upper nibble of a Float,
+/// so it is one pshufb lookup. The byte below it is the lowest exponent bit and the mantissa,
+/// (b & 0x1F) << 3, and the lower two bytes are zero.
+void DecodeFloatsSsse3(const std::uint8_t* packed, float* values, std::size_t count);
+void DecodeFloatsAvx2(const std::uint8_t* packed, float* values, std::size_t count);
+
+/// Widest of the kernels above the running CPU supports.
+DecodeKernel SelectDecodeKernel();
+const char* DecodeKernelName(DecodeKernel kernel);
+
+inline void DecodeFloats(const std::uint8_t* packed, float* values, std::size_t count)
+{
+	SelectDecodeKernel()(packed, values, count);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Cpu.h"
+
+#include <cstdint>
+
+#if CPU_X86
+#include <immintrin.h>
+
+/// Register level Float decoding, shared by the bulk decode kernels and the kernels that
+/// consume the decoded floats in the same pass. See DecodeFloatsSsse3 for the scheme.
+namespace FloatDecodeSimd
+{
+	/// Upper float byte per upper Float nibble s eee: s << 7 | (eee + 124) >> 1.
+	alignas(16) const std::uint8_t UPPER_BYTES[16] =
+	{
+		0x3E, 0x3E, 0x3F, 0x3F, 0x40, 0x40, 0x41, 0x41,
+		0xBE, 0xBE, 0xBF, 0xBF, 0xC0, 0xC0, 0xC1, 0xC1,
+	};
+
+	/// 16 Floats to 16 floats, in order.
+	TARGET_SSSE3 inline void Decode(__m128i bytes, __m128 (&floats)[4])
+	{
+		const __m128i upperTable = _mm_load_si128(reinterpret_cast<const __m128i*>(UPPER_BYTES));
+		const __m128i zero = _mm_setzero_si128();
+
+		const __m128i upper = _mm_shuffle_epi8(upperTable, _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F)));
+		/// Masked to 5 bits first, so the 16 bit shift cannot move bits into the neighbouring byte.
+		const __m128i lower = _mm_slli_epi16(_mm_and_si128(bytes, _mm_set1_epi8(0x1F)), 3);
+
+		const __m128i low = _mm_unpacklo_epi8(lower, upper);
+		const __m128i high = _mm_unpackhi_epi8(lower, upper);
+
+		floats[0] = _mm_castsi128_ps(_mm_unpacklo_epi16(zero, low));
+		floats[1] = _mm_castsi128_ps(_mm_unpackhi_epi16(zero, low));
+		floats[2] = _mm_castsi128_ps(_mm_unpacklo_epi16(zero, high));
+		floats[3] = _mm_castsi128_ps(_mm_unpackhi_epi16(zero, high));
+	}
+
+	/// 32 Floats to 32 floats, in order.
+	TARGET_AVX2 inline void Decode(__m256i bytes, __m256 (&floats)[4])
+	{
+		const __m256i upperTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(UPPER_BYTES)));
+		const __m256i zero = _mm256_setzero_si256();
+
+		const __m256i upper = _mm256_shuffle_epi8(upperTable, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F)));
+		const __m256i lower = _mm256_slli_epi16(_mm256_and_si256(bytes, _mm256_set1_epi8(0x1F)), 3);
+
+		/// The unpacks work within 128 bit lanes: low holds bytes 0-7 and 16-23, high bytes 8-15 and 24-31.
+		const __m256i low = _mm256_unpacklo_epi8(lower, upper);
+		const __m256i high = _mm256_unpackhi_epi8(lower, upper);
+
+		const __m256i floats0 = _mm256_unpacklo_epi16(zero, low);
+		const __m256i floats1 = _mm256_unpackhi_epi16(zero, low);
+		const __m256i floats2 = _mm256_unpacklo_epi16(zero, high);
+		const __m256i floats3 = _mm256_unpackhi_epi16(zero, high);
+
+		floats[0] = _mm256_castsi256_ps(_mm256_permute2x128_si256(floats0, floats1, 0x20));
+		floats[1] = _mm256_castsi256_ps(_mm256_permute2x128_si256(floats2, floats3, 0x20));
+		floats[2] = _mm256_castsi256_ps(_mm256_permute2x128_si256(floats0, floats1, 0x31));
+		floats[3] = _mm256_castsi256_ps(_mm256_permute2x128_si256(floats2, floats3, 0x31));
+	}
+}
+#endif
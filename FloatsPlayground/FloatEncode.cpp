@@ -0,0 +1,227 @@
+#include "FloatEncode.h"
+#include "Cpu.h"
+#include "Float.h"
+
+#include <cstring>
+
+#if CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	const std::uint32_t GOLDEN = 0x9E3779B9u;
+	/// Float patterns start at the float exponent 124, shifted into place.
+	const std::int32_t CODE_OFFSET = 124 << 4;
+
+	using FloatDetail::StochasticKey;
+
+	/// Uniform in [0, 2^19), the range of the dropped mantissa bits.
+	std::uint32_t StochasticIncrement(std::size_t index, const StochasticKey& key)
+	{
+		return FloatDetail::StochasticBits(index, key) >> 13;
+	}
+
+	template <RoundingMode Mode>
+	void EncodeScalar(const float* values, std::uint8_t* packed, std::size_t begin, std::size_t count, const StochasticKey& key)
+	{
+		for (std::size_t i = begin; i < count; ++i)
+		{
+			std::uint32_t bits;
+			std::memcpy(&bits, &values[i], sizeof(bits));
+
+			const std::uint32_t increment = Mode == RoundingMode::Nearest ? FloatDetail::NearestIncrement(bits) : StochasticIncrement(i, key);
+			packed[i] = FloatDetail::EncodeBits(bits, increment);
+		}
+	}
+
+#if CPU_X86
+	/// The vector kernels follow FloatDetail::EncodeBits and StochasticBits lane by lane.
+	template <RoundingMode Mode>
+	TARGET_SSE41 __m128i EncodeSse41(__m128i bits, __m128i indices, const StochasticKey& key)
+	{
+		__m128i increment;
+		if (Mode == RoundingMode::Nearest)
+		{
+			increment = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(bits, 19), _mm_set1_epi32(1)), _mm_set1_epi32(0x3FFFF));
+		}
+		else
+		{
+			__m128i value = _mm_add_epi32(_mm_mullo_epi32(indices, _mm_set1_epi32(static_cast<int>(GOLDEN))), _mm_set1_epi32(static_cast<int>(key.Low)));
+			value = _mm_xor_si128(value, _mm_srli_epi32(value, 16));
+			value = _mm_mullo_epi32(value, _mm_set1_epi32(0x7FEB352D));
+			value = _mm_xor_si128(value, _mm_srli_epi32(value, 15));
+			value = _mm_mullo_epi32(value, _mm_set1_epi32(static_cast<int>(0x846CA68Bu)));
+			value = _mm_xor_si128(value, _mm_srli_epi32(value, 16));
+			increment = _mm_srli_epi32(_mm_xor_si128(value, _mm_set1_epi32(static_cast<int>(key.High))), 13);
+		}
+
+		const __m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 24), _mm_set1_epi32(0x80));
+		const __m128i magnitude = _mm_and_si128(bits, _mm_set1_epi32(0x7FFFFFFF));
+
+		__m128i code = _mm_sub_epi32(_mm_srli_epi32(_mm_add_epi32(magnitude, increment), 19), _mm_set1_epi32(CODE_OFFSET));
+		code = _mm_min_epi32(_mm_max_epi32(code, _mm_setzero_si128()), _mm_set1_epi32(0x7F));
+
+		return _mm_or_si128(code, sign);
+	}
+
+	template <RoundingMode Mode>
+	TARGET_SSE41 void EncodeSse41Loop(const float* values, std::uint8_t* packed, std::size_t count, const StochasticKey& key)
+	{
+		const __m128i step = _mm_set1_epi32(4);
+		__m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i codes[4];
+			for (int k = 0; k < 4; ++k)
+			{
+				codes[k] = EncodeSse41<Mode>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 4 * k)), indices, key);
+				indices = _mm_add_epi32(indices, step);
+			}
+
+			/// Codes are at most 0xFF, so neither pack saturates.
+			const __m128i words = _mm_packus_epi16(_mm_packs_epi32(codes[0], codes[1]), _mm_packs_epi32(codes[2], codes[3]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i), words);
+		}
+
+		EncodeScalar<Mode>(values, packed, i, count, key);
+	}
+
+	template <RoundingMode Mode>
+	TARGET_AVX2 __m256i EncodeAvx2(__m256i bits, __m256i indices, const StochasticKey& key)
+	{
+		__m256i increment;
+		if (Mode == RoundingMode::Nearest)
+		{
+			increment = _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(bits, 19), _mm256_set1_epi32(1)), _mm256_set1_epi32(0x3FFFF));
+		}
+		else
+		{
+			__m256i value = _mm256_add_epi32(_mm256_mullo_epi32(indices, _mm256_set1_epi32(static_cast<int>(GOLDEN))), _mm256_set1_epi32(static_cast<int>(key.Low)));
+			value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 16));
+			value = _mm256_mullo_epi32(value, _mm256_set1_epi32(0x7FEB352D));
+			value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 15));
+			value = _mm256_mullo_epi32(value, _mm256_set1_epi32(static_cast<int>(0x846CA68Bu)));
+			value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 16));
+			increment = _mm256_srli_epi32(_mm256_xor_si256(value, _mm256_set1_epi32(static_cast<int>(key.High))), 13);
+		}
+
+		const __m256i sign = _mm256_and_si256(_mm256_srli_epi32(bits, 24), _mm256_set1_epi32(0x80));
+		const __m256i magnitude = _mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFFFF));
+
+		__m256i code = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_add_epi32(magnitude, increment), 19), _mm256_set1_epi32(CODE_OFFSET));
+		code = _mm256_min_epi32(_mm256_max_epi32(code, _mm256_setzero_si256()), _mm256_set1_epi32(0x7F));
+
+		return _mm256_or_si256(code, sign);
+	}
+
+	template <RoundingMode Mode>
+	TARGET_AVX2 void EncodeAvx2Loop(const float* values, std::uint8_t* packed, std::size_t count, const StochasticKey& key)
+	{
+		const __m256i step = _mm256_set1_epi32(8);
+		/// The packs interleave the 128 bit lanes, this puts the four byte groups back in order.
+		const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		__m256i indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			__m256i codes[4];
+			for (int k = 0; k < 4; ++k)
+			{
+				codes[k] = EncodeAvx2<Mode>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 8 * k)), indices, key);
+				indices = _mm256_add_epi32(indices, step);
+			}
+
+			const __m256i words = _mm256_packus_epi16(_mm256_packs_epi32(codes[0], codes[1]), _mm256_packs_epi32(codes[2], codes[3]));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(packed + i), _mm256_permutevar8x32_epi32(words, order));
+		}
+
+		EncodeScalar<Mode>(values, packed, i, count, key);
+	}
+#endif
+}
+
+void EncodeFloatsScalar(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed)
+{
+	const StochasticKey key = FloatDetail::MakeStochasticKey(seed);
+
+	if (mode == RoundingMode::Nearest)
+	{
+		EncodeScalar<RoundingMode::Nearest>(values, packed, 0, count, key);
+	}
+	else
+	{
+		EncodeScalar<RoundingMode::Stochastic>(values, packed, 0, count, key);
+	}
+}
+
+void EncodeFloatsSse41(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed)
+{
+#if CPU_X86
+	const StochasticKey key = FloatDetail::MakeStochasticKey(seed);
+
+	if (mode == RoundingMode::Nearest)
+	{
+		EncodeSse41Loop<RoundingMode::Nearest>(values, packed, count, key);
+	}
+	else
+	{
+		EncodeSse41Loop<RoundingMode::Stochastic>(values, packed, count, key);
+	}
+#else
+	EncodeFloatsScalar(values, packed, count, mode, seed);
+#endif
+}
+
+void EncodeFloatsAvx2(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed)
+{
+#if CPU_X86
+	const StochasticKey key = FloatDetail::MakeStochasticKey(seed);
+
+	if (mode == RoundingMode::Nearest)
+	{
+		EncodeAvx2Loop<RoundingMode::Nearest>(values, packed, count, key);
+	}
+	else
+	{
+		EncodeAvx2Loop<RoundingMode::Stochastic>(values, packed, count, key);
+	}
+#else
+	EncodeFloatsScalar(values, packed, count, mode, seed);
+#endif
+}
+
+EncodeKernel SelectEncodeKernel()
+{
+	const unsigned features = Cpu::Features();
+
+	if (features & Cpu::AVX2)
+	{
+		return EncodeFloatsAvx2;
+	}
+
+	if (features & Cpu::SSE41)
+	{
+		return EncodeFloatsSse41;
+	}
+
+	return EncodeFloatsScalar;
+}
+
+const char* EncodeKernelName(EncodeKernel kernel)
+{
+	if (kernel == EncodeFloatsAvx2)
+	{
+		return "AVX2";
+	}
+
+	if (kernel == EncodeFloatsSse41)
+	{
+		return "SSE4.1";
+	}
+
+	return "scalar";
+}
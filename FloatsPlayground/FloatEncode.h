@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class RoundingMode
+{
+	/// Round to nearest, ties to even.
+	Nearest,
+	/// Rounds up with probability equal to the distance from the Float below, so that the
+	/// quantization error averages out over many values. Reproducible for a given seed.
+	Stochastic,
+};
+
+namespace FloatDetail
+{
+	struct StochasticKey
+	{
+		std::uint32_t Low;
+		std::uint32_t High;
+	};
+
+	inline StochasticKey MakeStochasticKey(std::uint64_t seed)
+	{
+		std::uint64_t value = seed + 0x9E3779B97F4A7C15ull;
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		value ^= value >> 31;
+
+		StochasticKey key;
+		key.Low = static_cast<std::uint32_t>(value);
+		key.High = static_cast<std::uint32_t>(value >> 32);
+		return key;
+	}
+
+	/// 32 random bits for the value at index, a lowbias32 hash (by Chris Wellons) of the index and the key.
+	inline std::uint32_t StochasticBits(std::size_t index, const StochasticKey& key)
+	{
+		std::uint32_t value = static_cast<std::uint32_t>(index) * 0x9E3779B9u + key.Low;
+		value ^= value >> 16;
+		value *= 0x7FEB352Du;
+		value ^= value >> 15;
+		value *= 0x846CA68Bu;
+		value ^= value >> 16;
+		return value ^ key.High;
+	}
+}
+
+/// Converts count floats to packed Float bit patterns. Out of range values saturate,
+/// values below the smallest magnitude encode as it, see FloatDetail::EncodeBits.
+/// For stochastic rounding the random increment of every value is a hash of its index and the seed,
+/// so all kernels give the same result.
+typedef void (*EncodeKernel)(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed);
+
+void EncodeFloatsScalar(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed);
+void EncodeFloatsSse41(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed);
+void EncodeFloatsAvx2(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed);
+
+/// Widest of the kernels above the running CPU supports.
+EncodeKernel SelectEncodeKernel();
+const char* EncodeKernelName(EncodeKernel kernel);
+
+inline void EncodeFloats(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode = RoundingMode::Nearest, std::uint64_t seed = 0)
+{
+	SelectEncodeKernel()(values, packed, count, mode, seed);
+}
@@ -0,0 +1,80 @@
+#include "FloatOps.h"
+
+std::uint8_t FloatDetail::OPERATION_TABLES[OPERATIONS][OPERAND_PAIRS];
+
+/// The tables are generated at runtime instead of by constexpr functions.
+/// Four times 64K entries is far past the constexpr evaluation limits of MSVC.
+/// Static initialization runs on a single thread, the counter needs no synchronization.
+FloatDetail::OperationTablesInitializer::OperationTablesInitializer()
+{
+	static unsigned constructed = 0;
+	if (constructed++ > 0)
+	{
+		return;
+	}
+
+	for (unsigned lhs = 0; lhs < 256; ++lhs)
+	{
+		for (unsigned rhs = 0; rhs < 256; ++rhs)
+		{
+			const float a = float(Float(static_cast<char>(lhs)));
+			const float b = float(Float(static_cast<char>(rhs)));
+			const std::size_t pair = (lhs << 8) | rhs;
+
+			/// Sums and products of two 5 bit significands are exact in float. A quotient is
+			/// rounded twice, to float and then to Float, which gives the correctly rounded
+			/// result as float has more than 2 * 5 + 2 bits.
+			OPERATION_TABLES[static_cast<std::size_t>(FloatOps::Operation::Add)][pair] = Float::from_float(a + b).bits();
+			OPERATION_TABLES[static_cast<std::size_t>(FloatOps::Operation::Subtract)][pair] = Float::from_float(a - b).bits();
+			OPERATION_TABLES[static_cast<std::size_t>(FloatOps::Operation::Multiply)][pair] = Float::from_float(a * b).bits();
+			OPERATION_TABLES[static_cast<std::size_t>(FloatOps::Operation::Divide)][pair] = Float::from_float(a / b).bits();
+		}
+	}
+}
+
+void FloatOps::Apply(Operation operation, const std::uint8_t* lhs, const std::uint8_t* rhs, std::uint8_t* result, std::size_t count)
+{
+	const std::uint8_t* table = Table(operation);
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		result[i] = Apply(table, lhs[i], rhs[i]);
+	}
+}
+
+Float FloatOps::Sum(const std::uint8_t* values, std::size_t count)
+{
+	if (count == 0)
+	{
+		return Float::from_float(0.f);
+	}
+
+	const std::uint8_t* add = Table(Operation::Add);
+
+	std::uint8_t sum = values[0];
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		sum = Apply(add, sum, values[i]);
+	}
+
+	return Float(static_cast<char>(sum));
+}
+
+Float FloatOps::Dot(const std::uint8_t* lhs, const std::uint8_t* rhs, std::size_t count)
+{
+	if (count == 0)
+	{
+		return Float::from_float(0.f);
+	}
+
+	const std::uint8_t* add = Table(Operation::Add);
+	const std::uint8_t* multiply = Table(Operation::Multiply);
+
+	std::uint8_t sum = Apply(multiply, lhs[0], rhs[0]);
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		sum = Apply(add, sum, Apply(multiply, lhs[i], rhs[i]));
+	}
+
+	return Float(static_cast<char>(sum));
+}
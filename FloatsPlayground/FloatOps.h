@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Float.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace FloatDetail
+{
+	const std::size_t OPERATIONS = 4;
+	const std::size_t OPERAND_PAIRS = 256 * 256;
+
+	/// Results of every operation, filled by the first OperationTablesInitializer to run.
+	/// Every translation unit including this header constructs one before its own static objects,
+	/// so the tables are ready even for those, without a guard on every lookup.
+	extern std::uint8_t OPERATION_TABLES[OPERATIONS][OPERAND_PAIRS];
+
+	struct OperationTablesInitializer
+	{
+		OperationTablesInitializer();
+	};
+
+	static const OperationTablesInitializer OPERATION_TABLES_INITIALIZER;
+}
+
+/// Arithmetic on Float through tables of all 64K operand pairs, indexed by lhs << 8 | rhs.
+/// Every entry is the exact result rounded to nearest, ties to even, so a chain of operations
+/// never leaves the 8 bit format. As there is no zero, x - x gives the smallest magnitude, 0.125.
+namespace FloatOps
+{
+	enum class Operation
+	{
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Count,
+	};
+
+	const std::uint8_t* Table(Operation operation);
+
+	inline std::uint8_t Apply(const std::uint8_t* table, std::uint8_t lhs, std::uint8_t rhs)
+	{
+		return table[(static_cast<unsigned>(lhs) << 8) | rhs];
+	}
+
+	/// result[i] = lhs[i] op rhs[i], result may alias either operand.
+	void Apply(Operation operation, const std::uint8_t* lhs, const std::uint8_t* rhs, std::uint8_t* result, std::size_t count);
+
+	/// Left to right reductions, rounded to Float after every step.
+	Float Sum(const std::uint8_t* values, std::size_t count);
+	Float Dot(const std::uint8_t* lhs, const std::uint8_t* rhs, std::size_t count);
+}
+
+static_assert(static_cast<std::size_t>(FloatOps::Operation::Count) == FloatDetail::OPERATIONS, "Every operation needs a table");
+
+inline const std::uint8_t* FloatOps::Table(Operation operation)
+{
+	return FloatDetail::OPERATION_TABLES[static_cast<std::size_t>(operation)];
+}
+
+inline Float operator+(Float lhs, Float rhs)
+{
+	return Float(static_cast<char>(FloatOps::Apply(FloatOps::Table(FloatOps::Operation::Add), lhs.bits(), rhs.bits())));
+}
+
+inline Float operator-(Float lhs, Float rhs)
+{
+	return Float(static_cast<char>(FloatOps::Apply(FloatOps::Table(FloatOps::Operation::Subtract), lhs.bits(), rhs.bits())));
+}
+
+inline Float operator*(Float lhs, Float rhs)
+{
+	return Float(static_cast<char>(FloatOps::Apply(FloatOps::Table(FloatOps::Operation::Multiply), lhs.bits(), rhs.bits())));
+}
+
+inline Float operator/(Float lhs, Float rhs)
+{
+	return Float(static_cast<char>(FloatOps::Apply(FloatOps::Table(FloatOps::Operation::Divide), lhs.bits(), rhs.bits())));
+}
+
+inline Float operator-(Float value)
+{
+	return Float(static_cast<char>(value.bits() ^ 0x80u));
+}
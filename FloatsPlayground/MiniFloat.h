@@ -0,0 +1,346 @@
+#pragma once
+
+#include "FloatDecode.h"
+#include "FloatEncode.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+/// How the exponent field is read at its extremes.
+enum class MiniFloatKind
+{
+	/// Every pattern is a normal number, there is no zero, no infinity and no NaN, like Float.
+	AllNormal,
+	/// IEEE 754: exponent 0 holds zero and subnormals, the all ones exponent infinities and NaNs.
+	Ieee,
+	/// Like Ieee without infinities, only the all ones pattern is NaN, as FP8 E4M3.
+	FiniteNan,
+};
+
+namespace MiniFloatDetail
+{
+	constexpr double Pow2(int exponent)
+	{
+		double value = 1.0;
+
+		for (int i = 0; i < exponent; ++i)
+		{
+			value *= 2.0;
+		}
+
+		for (int i = exponent; i < 0; ++i)
+		{
+			value /= 2.0;
+		}
+
+		return value;
+	}
+
+	struct DecodeTable
+	{
+		float Values[256];
+	};
+
+	/// Outside of MiniFloat, which is still incomplete in its own member initializers.
+	template <typename Format>
+	struct DecodeTableOf
+	{
+		static constexpr DecodeTable TABLE = Format::MakeDecodeTable();
+	};
+
+	template <typename Format>
+	constexpr DecodeTable DecodeTableOf<Format>::TABLE;
+}
+
+/// Sign bit, ExpBits exponent bits with the given Bias and MantBits mantissa bits, at most 16 bits in total.
+/// Encoding works on the bits of the float, see from_float. Decoding goes through a table generated
+/// at compile time for 8 bit formats and builds the float bits directly for wider ones.
+/// Values have to fit the float exponent range, so every value converts to float exactly.
+template <unsigned ExpBits, unsigned MantBits, int Bias, MiniFloatKind Kind>
+class MiniFloat
+{
+public:
+	static const unsigned EXPONENT_BITS = ExpBits;
+	static const unsigned MANTISSA_BITS = MantBits;
+	static const unsigned BITS = 1 + ExpBits + MantBits;
+	static const MiniFloatKind KIND = Kind;
+
+	static_assert(ExpBits >= 1 && MantBits >= 1 && BITS <= 16, "MiniFloat holds at most 16 bits");
+	static_assert(MantBits <= 22, "The mantissa has to be narrower than the float one");
+
+	typedef typename std::conditional<BITS <= 8, std::uint8_t, std::uint16_t>::type Storage;
+
+	static const bool HAS_SUBNORMALS = Kind != MiniFloatKind::AllNormal;
+	static const unsigned MANTISSA_MASK = (1u << MantBits) - 1;
+	static const unsigned EXPONENT_MAX = (1u << ExpBits) - 1;
+	static const unsigned SIGN_MASK = 1u << (BITS - 1);
+
+	/// Magnitude patterns, without the sign bit.
+	static const unsigned MAX_FINITE = Kind == MiniFloatKind::AllNormal ? (1u << (ExpBits + MantBits)) - 1
+		: Kind == MiniFloatKind::Ieee ? (EXPONENT_MAX << MantBits) - 1
+		: (1u << (ExpBits + MantBits)) - 2;
+	static const unsigned INFINITY_PATTERN = EXPONENT_MAX << MantBits;
+	/// AllNormal has no NaN, NaN saturates there like infinity does.
+	static const unsigned NAN_PATTERN = Kind == MiniFloatKind::AllNormal ? MAX_FINITE
+		: Kind == MiniFloatKind::Ieee ? INFINITY_PATTERN | (1u << (MantBits - 1))
+		: (1u << (ExpBits + MantBits)) - 1;
+
+	/// Unbiased exponent of the smallest normal number.
+	static const int MIN_EXPONENT = HAS_SUBNORMALS ? 1 - Bias : -Bias;
+	static const int MAX_EXPONENT = static_cast<int>(Kind == MiniFloatKind::Ieee ? EXPONENT_MAX - 1 : EXPONENT_MAX) - Bias;
+
+	static_assert(MIN_EXPONENT >= -126 && MAX_EXPONENT <= 127, "Values have to fit the float exponent range");
+
+	MiniFloat() : m_Bits(0) { }
+
+	static MiniFloat from_bits(Storage bits)
+	{
+		MiniFloat number;
+		number.m_Bits = bits;
+		return number;
+	}
+
+	/// Nearest value, ties to even. Out of range values become infinity for Ieee and saturate otherwise.
+	/// For AllNormal, magnitudes below the smallest one encode as it.
+	static MiniFloat from_float(float value)
+	{
+		return from_bits(Encode(value, RoundingMode::Nearest, 0));
+	}
+
+	/// Rounds up with probability equal to the distance from the value below, random are 32 uniform bits.
+	static MiniFloat from_float_stochastic(float value, std::uint32_t random)
+	{
+		return from_bits(Encode(value, RoundingMode::Stochastic, random));
+	}
+
+	Storage bits() const
+	{
+		return m_Bits;
+	}
+
+	operator float() const
+	{
+		return Decode(m_Bits, std::integral_constant<bool, BITS <= 8>());
+	}
+
+	int sign() const
+	{
+		return m_Bits & SIGN_MASK ? -1 : 1;
+	}
+
+	bool is_nan() const
+	{
+		const unsigned magnitude = m_Bits & ~SIGN_MASK;
+
+		return (Kind == MiniFloatKind::FiniteNan && magnitude == NAN_PATTERN)
+			|| (Kind == MiniFloatKind::Ieee && magnitude > INFINITY_PATTERN);
+	}
+
+	/// Value of a pattern from its fields, so that it can run at compile time.
+	static constexpr float DecodeValue(unsigned bits)
+	{
+		const unsigned exponent = (bits >> MantBits) & EXPONENT_MAX;
+		const unsigned mantissa = bits & MANTISSA_MASK;
+		const float sign = (bits & SIGN_MASK) ? -1.f : 1.f;
+
+		if (Kind == MiniFloatKind::Ieee && exponent == EXPONENT_MAX)
+		{
+			return mantissa == 0 ? sign * std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+		}
+
+		if (Kind == MiniFloatKind::FiniteNan && exponent == EXPONENT_MAX && mantissa == MANTISSA_MASK)
+		{
+			return std::numeric_limits<float>::quiet_NaN();
+		}
+
+		if (HAS_SUBNORMALS && exponent == 0)
+		{
+			return sign * static_cast<float>(mantissa * MiniFloatDetail::Pow2(1 - Bias - static_cast<int>(MantBits)));
+		}
+
+		return sign * static_cast<float>(((1u << MantBits) + mantissa) * MiniFloatDetail::Pow2(static_cast<int>(exponent) - Bias - static_cast<int>(MantBits)));
+	}
+
+	static constexpr MiniFloatDetail::DecodeTable MakeDecodeTable()
+	{
+		MiniFloatDetail::DecodeTable table{};
+
+		for (unsigned bits = 0; bits < 256; ++bits)
+		{
+			table.Values[bits] = DecodeValue(bits);
+		}
+
+		return table;
+	}
+
+private:
+	/// 8 bit formats read the table.
+	static float Decode(Storage bits, std::true_type)
+	{
+		return MiniFloatDetail::DecodeTableOf<MiniFloat>::TABLE.Values[bits];
+	}
+
+	/// Wider ones build the float bits, a 64K entry table would not be worth the cache it takes.
+	static float Decode(Storage bits, std::false_type)
+	{
+		const unsigned exponent = (bits >> MantBits) & EXPONENT_MAX;
+		const unsigned mantissa = bits & MANTISSA_MASK;
+		const std::uint32_t sign = (bits & SIGN_MASK) ? 0x80000000u : 0u;
+
+		if ((Kind == MiniFloatKind::Ieee && exponent == EXPONENT_MAX)
+			|| (Kind == MiniFloatKind::FiniteNan && exponent == EXPONENT_MAX && mantissa == MANTISSA_MASK))
+		{
+			return mantissa == 0 && Kind == MiniFloatKind::Ieee
+				? (sign ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity())
+				: std::numeric_limits<float>::quiet_NaN();
+		}
+
+		if (HAS_SUBNORMALS && exponent == 0)
+		{
+			constexpr double SUBNORMAL_UNIT = MiniFloatDetail::Pow2(1 - Bias - static_cast<int>(MantBits));
+
+			const float value = static_cast<float>(mantissa * SUBNORMAL_UNIT);
+			return sign ? -value : value;
+		}
+
+		const std::uint32_t floatBits = sign
+			| static_cast<std::uint32_t>(static_cast<int>(exponent) - Bias + 127) << 23
+			| static_cast<std::uint32_t>(mantissa) << (23 - MantBits);
+
+		float value;
+		std::memcpy(&value, &floatBits, sizeof(value));
+		return value;
+	}
+
+	/// Same scheme as FloatDetail::EncodeBits: after adding the rounding increment to the dropped
+	/// mantissa bits, the float magnitude shifted right is the pattern, offset by the exponent bias.
+	/// Subnormal results are rounded from the value scaled to units of the smallest subnormal.
+	static Storage Encode(float value, RoundingMode mode, std::uint32_t random)
+	{
+		const unsigned SHIFT = 23 - MantBits;
+		/// The float exponent of pattern exponent 0, shifted into place.
+		const std::int64_t OFFSET = static_cast<std::int64_t>(127 - Bias) << MantBits;
+
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		const unsigned sign = (bits >> 31) ? SIGN_MASK : 0u;
+		const std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+		if (magnitude > 0x7F800000u)
+		{
+			return static_cast<Storage>(sign | NAN_PATTERN);
+		}
+
+		if (magnitude == 0x7F800000u)
+		{
+			return static_cast<Storage>(sign | (Kind == MiniFloatKind::Ieee ? INFINITY_PATTERN : MAX_FINITE));
+		}
+
+		if (HAS_SUBNORMALS && static_cast<int>(magnitude >> 23) < 127 + MIN_EXPONENT)
+		{
+			const double scaled = (value < 0.f ? -value : value) * MiniFloatDetail::Pow2(Bias - 1 + static_cast<int>(MantBits));
+			const double below = static_cast<double>(static_cast<std::uint32_t>(scaled));
+			const double fraction = scaled - below;
+
+			bool up;
+			if (mode == RoundingMode::Nearest)
+			{
+				up = fraction > 0.5 || (fraction == 0.5 && (static_cast<std::uint32_t>(below) & 1u));
+			}
+			else
+			{
+				up = fraction > random * (1.0 / 4294967296.0);
+			}
+
+			/// Rounding up from the largest subnormal gives the smallest normal, which is the next pattern.
+			return static_cast<Storage>(sign | (static_cast<std::uint32_t>(below) + (up ? 1u : 0u)));
+		}
+
+		const std::uint32_t increment = mode == RoundingMode::Nearest
+			? (1u << (SHIFT - 1)) - 1 + ((magnitude >> SHIFT) & 1u)
+			: random >> (32 - SHIFT);
+
+		std::int64_t pattern = static_cast<std::int64_t>((static_cast<std::uint64_t>(magnitude) + increment) >> SHIFT) - OFFSET;
+
+		if (pattern < 0)
+		{
+			pattern = 0;
+		}
+
+		if (pattern > static_cast<std::int64_t>(MAX_FINITE))
+		{
+			pattern = Kind == MiniFloatKind::Ieee ? INFINITY_PATTERN : MAX_FINITE;
+		}
+
+		return static_cast<Storage>(sign | static_cast<unsigned>(pattern));
+	}
+
+	Storage m_Bits;
+};
+
+/// Same layout as Float.
+typedef MiniFloat<3, 4, 3, MiniFloatKind::AllNormal> Float8;
+/// FP8 formats as used for machine learning, E4M3 saturates at 448 and E5M2 keeps infinities.
+typedef MiniFloat<4, 3, 7, MiniFloatKind::FiniteNan> E4M3;
+typedef MiniFloat<5, 2, 15, MiniFloatKind::Ieee> E5M2;
+/// IEEE 754 binary16 and bfloat16, the upper half of a float.
+typedef MiniFloat<5, 10, 15, MiniFloatKind::Ieee> Half;
+typedef MiniFloat<8, 7, 127, MiniFloatKind::Ieee> BFloat16;
+
+/// Bulk conversions, compiled separately for every format so the layout constants fold into the loop.
+template <typename Format>
+void DecodeMiniFloats(const typename Format::Storage* packed, float* values, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		values[i] = Format::from_bits(packed[i]);
+	}
+}
+
+/// Random bits for stochastic rounding are the same as EncodeFloats uses, per index and seed.
+template <typename Format>
+void EncodeMiniFloats(const float* values, typename Format::Storage* packed, std::size_t count, RoundingMode mode = RoundingMode::Nearest, std::uint64_t seed = 0)
+{
+	if (mode == RoundingMode::Nearest)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			packed[i] = Format::from_float(values[i]).bits();
+		}
+		return;
+	}
+
+	const FloatDetail::StochasticKey key = FloatDetail::MakeStochasticKey(seed);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		packed[i] = Format::from_float_stochastic(values[i], FloatDetail::StochasticBits(i, key)).bits();
+	}
+}
+
+/// Float8 has the vector kernels of Float.
+template <>
+inline void DecodeMiniFloats<Float8>(const std::uint8_t* packed, float* values, std::size_t count)
+{
+	DecodeFloats(packed, values, count);
+}
+
+template <>
+inline void EncodeMiniFloats<Float8>(const float* values, std::uint8_t* packed, std::size_t count, RoundingMode mode, std::uint64_t seed)
+{
+	EncodeFloats(values, packed, count, mode, seed);
+}
+
+/// bfloat16 is the upper half of a float, decoding is a shift.
+template <>
+inline void DecodeMiniFloats<BFloat16>(const std::uint16_t* packed, float* values, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const std::uint32_t bits = static_cast<std::uint32_t>(packed[i]) << 16;
+		std::memcpy(&values[i], &bits, sizeof(bits));
+	}
+}
@@ -0,0 +1,360 @@
+#include "Properties.h"
+#include "Cpu.h"
+#include "Float.h"
+#include "FloatDecode.h"
+#include "FloatEncode.h"
+#include "FloatOps.h"
+#include "MiniFloat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+	/// Every Float is (16 + mantissa) * 2^(exponent - 7), an integer times a power of two.
+	/// All values below are derived from that, never from the Float code under test.
+	struct Exact
+	{
+		int Sign;
+		int Significand;
+		int Exponent;
+	};
+
+	Exact ExactOf(unsigned bits)
+	{
+		Exact exact;
+		exact.Sign = bits & 0x80u ? -1 : 1;
+		exact.Significand = 16 + static_cast<int>(bits & 0x0Fu);
+		exact.Exponent = static_cast<int>((bits >> 4) & 0x7u) - 7;
+		return exact;
+	}
+
+	/// Every Float, as well as the products of two, is exact in a double.
+	double ValueOf(const Exact& exact)
+	{
+		return exact.Sign * std::ldexp(static_cast<double>(exact.Significand), exact.Exponent);
+	}
+
+	/// Spacing of the Floats in the binade of a value in [0.125, 32).
+	double FloatUlp(double value)
+	{
+		int exponent;
+		std::frexp(std::fabs(value), &exponent);
+		return std::ldexp(1.0, exponent - 5);
+	}
+
+	/// In ULPs of the exact value, so a correctly rounded result is at most 0.5 away.
+	double FloatUlpError(double result, double exact)
+	{
+		return std::fabs(result - exact) / FloatUlp(exact);
+	}
+
+	/// Whether bits has the sign of the exact value and is at least as close to it as both of its
+	/// neighbours, being the even one on a tie. distanceOf gives the distance of a value to the exact one.
+	template <typename DistanceOf>
+	bool IsNearest(unsigned bits, bool negative, DistanceOf distanceOf)
+	{
+		if (((bits & 0x80u) != 0) != negative)
+		{
+			return false;
+		}
+
+		const double distance = distanceOf(ValueOf(ExactOf(bits)));
+		for (int step = -1; step <= 1; step += 2)
+		{
+			const unsigned magnitude = (bits & 0x7Fu) + step;
+			if (magnitude > 0x7F)
+			{
+				continue;
+			}
+
+			const double other = distanceOf(ValueOf(ExactOf((bits & 0x80u) | magnitude)));
+			if (other < distance || (other == distance && (bits & 1u)))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// Reports the largest error of one check, which fails when it exceeds the limit.
+	class Check
+	{
+	public:
+		Check(const char* name, double limit)
+			: m_Name(name)
+			, m_Limit(limit)
+			, m_MaxError(0.0)
+			, m_Cases(0)
+			, m_Failures(0)
+		{
+		}
+
+		void Add(double error)
+		{
+			++m_Cases;
+			m_MaxError = std::max(m_MaxError, error);
+
+			/// NaN errors fail as well.
+			if (!(error <= m_Limit))
+			{
+				++m_Failures;
+			}
+		}
+
+		void AddExact(bool passed)
+		{
+			Add(passed ? 0.0 : HUGE_VAL);
+		}
+
+		unsigned Report() const
+		{
+			std::printf("%-34s %8u %12.4g %10s\n", m_Name, m_Cases, m_MaxError, m_Failures == 0 ? "ok" : "FAILED");
+			return m_Failures;
+		}
+
+	private:
+		const char* m_Name;
+		double m_Limit;
+		double m_MaxError;
+		unsigned m_Cases;
+		unsigned m_Failures;
+	};
+
+	std::vector<DecodeKernel> DecodeKernels()
+	{
+		std::vector<DecodeKernel> kernels = { DecodeFloatsScalar };
+		if (Cpu::Features() & Cpu::SSSE3)
+		{
+			kernels.push_back(DecodeFloatsSsse3);
+		}
+		if (Cpu::Features() & Cpu::AVX2)
+		{
+			kernels.push_back(DecodeFloatsAvx2);
+		}
+		return kernels;
+	}
+
+	std::vector<EncodeKernel> EncodeKernels()
+	{
+		std::vector<EncodeKernel> kernels = { EncodeFloatsScalar };
+		if (Cpu::Features() & Cpu::SSE41)
+		{
+			kernels.push_back(EncodeFloatsSse41);
+		}
+		if (Cpu::Features() & Cpu::AVX2)
+		{
+			kernels.push_back(EncodeFloatsAvx2);
+		}
+		return kernels;
+	}
+
+	unsigned CheckFields()
+	{
+		Check fields("fields", 0.0);
+
+		for (unsigned bits = 0; bits < 256; ++bits)
+		{
+			const Float number(static_cast<char>(bits));
+			const Exact exact = ExactOf(bits);
+
+			fields.AddExact(number.bits() == bits);
+			fields.AddExact(number.sign() == exact.Sign);
+			fields.AddExact(static_cast<int>(number.biased_exponent()) == exact.Exponent + 7);
+			fields.AddExact(number.actual_exponent() == exact.Exponent + 4);
+			fields.AddExact(number.mantissa() == exact.Significand / 16.0);
+		}
+
+		return fields.Report();
+	}
+
+	/// Float ULPs are used for every check, a decode error of one float ULP would be far below 0.001.
+	unsigned CheckDecode()
+	{
+		Check conversion("decode float()", 0.0);
+		Check kernels("decode kernels", 0.0);
+		Check float8("decode Float8", 0.0);
+		Check order("order of the patterns", 0.0);
+
+		std::vector<std::uint8_t> packed(256 + 31);
+		for (std::size_t i = 0; i < packed.size(); ++i)
+		{
+			packed[i] = static_cast<std::uint8_t>(i);
+		}
+
+		std::vector<std::vector<float>> decoded;
+		for (DecodeKernel kernel : DecodeKernels())
+		{
+			decoded.emplace_back(packed.size());
+			kernel(packed.data(), decoded.back().data(), packed.size());
+		}
+
+		for (unsigned bits = 0; bits < 256; ++bits)
+		{
+			const double reference = ValueOf(ExactOf(bits));
+
+			conversion.Add(FloatUlpError(float(Float(static_cast<char>(bits))), reference));
+			float8.Add(FloatUlpError(float(Float8::from_bits(static_cast<std::uint8_t>(bits))), reference));
+
+			for (const std::vector<float>& values : decoded)
+			{
+				kernels.Add(FloatUlpError(values[bits], reference));
+			}
+
+			for (unsigned other = 0; other < 256; ++other)
+			{
+				const double otherReference = ValueOf(ExactOf(other));
+				order.AddExact((Float(static_cast<char>(bits)) < Float(static_cast<char>(other))) == (reference < otherReference));
+			}
+		}
+
+		return conversion.Report() + kernels.Report() + float8.Report() + order.Report();
+	}
+
+	/// Every pattern, the midpoints to its neighbours and the floats right next to those midpoints,
+	/// which are the hardest cases of round to nearest.
+	unsigned CheckEncode()
+	{
+		Check roundTrip("encode round trip", 0.0);
+		Check nearest("encode nearest", 0.5);
+		Check ties("encode ties to even", 0.0);
+		Check saturation("encode saturation", 0.0);
+
+		std::vector<float> values;
+		for (unsigned bits = 0; bits < 256; ++bits)
+		{
+			values.push_back(static_cast<float>(ValueOf(ExactOf(bits))));
+		}
+
+		/// Adjacent magnitudes differ by one in their patterns, the midpoint is exact in a float.
+		const std::size_t midpoints = values.size();
+		for (unsigned bits = 0; bits < 256; ++bits)
+		{
+			if ((bits & 0x7Fu) != 0x7F)
+			{
+				const float midpoint = static_cast<float>((ValueOf(ExactOf(bits)) + ValueOf(ExactOf(bits + 1))) / 2);
+
+				values.push_back(std::nextafter(midpoint, 0.f));
+				values.push_back(midpoint);
+				values.push_back(std::nextafter(midpoint, 2 * midpoint));
+			}
+		}
+
+		const std::size_t outside = values.size();
+		const float outsideValues[] = { 0.f, -0.f, 1e-30f, -0.0625f, 31.5f, -100.f, HUGE_VALF, -HUGE_VALF };
+		values.insert(values.end(), std::begin(outsideValues), std::end(outsideValues));
+
+		std::vector<std::uint8_t> packed(values.size());
+		for (EncodeKernel kernel : EncodeKernels())
+		{
+			kernel(values.data(), packed.data(), values.size(), RoundingMode::Nearest, 0);
+
+			for (std::size_t i = 0; i < values.size(); ++i)
+			{
+				const unsigned bits = packed[i];
+				const double value = values[i];
+
+				if (i < midpoints)
+				{
+					roundTrip.AddExact(bits == i);
+				}
+				else if (i < outside)
+				{
+					const bool isNearest = IsNearest(bits, value < 0.0, [value](double candidate) { return std::fabs(candidate - value); });
+					nearest.Add(isNearest ? FloatUlpError(ValueOf(ExactOf(bits)), value) : HUGE_VAL);
+
+					if ((i - midpoints) % 3 == 1)
+					{
+						ties.AddExact((bits & 1u) == 0);
+					}
+				}
+				else
+				{
+					/// Saturates to the closest magnitude and keeps the sign.
+					const unsigned sign = std::signbit(values[i]) ? 0x80u : 0u;
+					saturation.AddExact(bits == (sign | (std::fabs(value) > 1.0 ? 0x7Fu : 0u)));
+				}
+			}
+		}
+
+		return roundTrip.Report() + nearest.Report() + ties.Report() + saturation.Report();
+	}
+
+	double ExactResult(FloatOps::Operation operation, double lhs, double rhs)
+	{
+		switch (operation)
+		{
+		case FloatOps::Operation::Add:
+			return lhs + rhs;
+		case FloatOps::Operation::Subtract:
+			return lhs - rhs;
+		case FloatOps::Operation::Multiply:
+			return lhs * rhs;
+		default:
+			return lhs / rhs;
+		}
+	}
+
+	/// Sums, differences and products of two Floats are exact in a double, quotients are not.
+	/// For those the distance of a candidate is measured as |candidate * rhs - lhs|, which is exact and
+	/// |rhs| times the true distance, so it orders the candidates the same.
+	double Distance(FloatOps::Operation operation, double candidate, double lhs, double rhs)
+	{
+		if (operation == FloatOps::Operation::Divide)
+		{
+			return std::fabs(candidate * rhs - lhs);
+		}
+
+		return std::fabs(candidate - ExactResult(operation, lhs, rhs));
+	}
+
+	/// Results that saturate are only checked for that, the ULP error is reported over the others.
+	/// x - x saturates to the smallest magnitude of either sign.
+	unsigned CheckOperation(FloatOps::Operation operation, const char* name, const char* saturatedName)
+	{
+		Check correct(name, 0.5);
+		Check saturated(saturatedName, 0.0);
+		const std::uint8_t* table = FloatOps::Table(operation);
+
+		for (unsigned lhs = 0; lhs < 256; ++lhs)
+		{
+			for (unsigned rhs = 0; rhs < 256; ++rhs)
+			{
+				const double x = ValueOf(ExactOf(lhs));
+				const double y = ValueOf(ExactOf(rhs));
+				const unsigned bits = FloatOps::Apply(table, static_cast<std::uint8_t>(lhs), static_cast<std::uint8_t>(rhs));
+				const double exact = ExactResult(operation, x, y);
+
+				if (std::fabs(exact) > 31.0 || std::fabs(exact) < 0.125)
+				{
+					const unsigned sign = exact < 0.0 || (exact == 0.0 && (bits & 0x80u)) ? 0x80u : 0u;
+					saturated.AddExact(bits == (sign | (std::fabs(exact) > 31.0 ? 0x7Fu : 0u)));
+					continue;
+				}
+
+				const bool isNearest = IsNearest(bits, exact < 0.0, [operation, x, y](double candidate) { return Distance(operation, candidate, x, y); });
+				correct.Add(isNearest ? FloatUlpError(ValueOf(ExactOf(bits)), exact) : HUGE_VAL);
+			}
+		}
+
+		return correct.Report() + saturated.Report();
+	}
+}
+
+unsigned CheckFloatProperties()
+{
+	std::printf("%-34s %8s %12s %10s\n", "check", "cases", "max ULP", "result");
+
+	unsigned failures = CheckFields() + CheckDecode() + CheckEncode();
+	failures += CheckOperation(FloatOps::Operation::Add, "add", "add saturated");
+	failures += CheckOperation(FloatOps::Operation::Subtract, "subtract", "subtract saturated");
+	failures += CheckOperation(FloatOps::Operation::Multiply, "multiply", "multiply saturated");
+	failures += CheckOperation(FloatOps::Operation::Divide, "divide", "divide saturated");
+
+	return failures;
+}
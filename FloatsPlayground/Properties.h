@@ -0,0 +1,8 @@
+#pragma once
+
+/// Checks every one of the 256 Float patterns and all 65536 operand pairs of every
+/// FloatOps operation against references built from integer arithmetic, and prints
+/// the largest error of every check in ULPs.
+/// Unlike the asserts in main.cpp this also runs in builds with NDEBUG.
+/// Returns the count of failed checks.
+unsigned CheckFloatProperties();
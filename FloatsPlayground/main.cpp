@@ -1,61 +1,22 @@
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
 
-class Float
-{
-public:
-	Float(char number = 0) : m_Buffer(number) { }
-
-	operator float()
-	{
-		//TODO
-	}
-
-	int sign()
-	{
-		return m_Buffer & (1u << 7) ? -1 : 1;
-	}
-
-	unsigned biased_exponent()
-	{
-		return (m_Buffer & 0x70u) >> 4;
-	}
-
-	int actual_exponent()
-	{
-		return biased_exponent() - 3;
-	}
-
-	float mantissa()
-	{
-		float mantissa = 1.f;
-
-		if (m_Buffer & (1u << 3))
-		{
-			mantissa += 0.5f;
-		}
-
-		if (m_Buffer & (1u << 2))
-		{
-			mantissa += 0.25f;
-		}
-
-		if (m_Buffer & (1u << 1))
-		{
-			mantissa += 0.125f;
-		}
-
-		if (m_Buffer & (1u << 0))
-		{
-			mantissa += 0.0625f;
-		}
-
-		return mantissa;
-	}
-
-private:
-	char m_Buffer;
-};
+#include "Benchmark.h"
+#include "Cpu.h"
+#include "Float.h"
+#include "FloatColumn.h"
+#include "FloatDecode.h"
+#include "FloatEncode.h"
+#include "FloatOps.h"
+#include "MiniFloat.h"
+#include "Properties.h"
 
 void TestSign()
 {
@@ -137,26 +98,539 @@ void TestActualExponent()
 
 void TestMantissa()
 {
-	float epsilon = 0.00001;
+	const float epsilon = 0.00001f;
+
+	assert(std::fabs(Float(0x08).mantissa() - 1.5f) < epsilon);
+	assert(std::fabs(Float(0x07).mantissa() - 1.4375f) < epsilon);
+	assert(std::fabs(Float(0x06).mantissa() - 1.375f) < epsilon);
+	assert(std::fabs(Float(0x05).mantissa() - 1.3125f) < epsilon);
+	assert(std::fabs(Float(0x04).mantissa() - 1.25f) < epsilon);
+	assert(std::fabs(Float(0x03).mantissa() - 1.1875f) < epsilon);
+	assert(std::fabs(Float(0x02).mantissa() - 1.125f) < epsilon);
+	assert(std::fabs(Float(0x01).mantissa() - 1.0625f) < epsilon);
+	assert(std::fabs(Float(0x00).mantissa() - 1.f) < epsilon);
+	assert(std::fabs(Float(0x7F).mantissa() - 1.9375f) < epsilon);
+	assert(std::fabs(Float(char(0x8F)).mantissa() - 1.9375f) < epsilon);
+}
+
+void TestConversion()
+{
+	for (int i = 0; i < 256; ++i)
+	{
+		const Float number(static_cast<char>(i));
+		const float expected = number.sign() * number.mantissa() * std::ldexp(1.f, number.actual_exponent());
+
+		assert(float(number) == expected);
+	}
+
+	assert(float(Float(0x00)) == 0.125f);
+	assert(float(Float(0x30)) == 1.f);
+	assert(float(Float(0x7F)) == 31.f);
+	assert(float(Float(char(0xB8))) == -1.5f);
+}
+
+void TestBulkDecode()
+{
+	std::vector<DecodeKernel> kernels = { DecodeFloatsScalar };
+	if (Cpu::Features() & Cpu::SSSE3)
+	{
+		kernels.push_back(DecodeFloatsSsse3);
+	}
+	if (Cpu::Features() & Cpu::AVX2)
+	{
+		kernels.push_back(DecodeFloatsAvx2);
+	}
+
+	/// Every pattern at every position of a vector, plus tails of every length.
+	std::vector<std::uint8_t> packed(256 * 3 + 31);
+	for (std::size_t i = 0; i < packed.size(); ++i)
+	{
+		packed[i] = static_cast<std::uint8_t>(i * 7);
+	}
+
+	for (DecodeKernel kernel : kernels)
+	{
+		for (std::size_t count = 0; count <= 64; ++count)
+		{
+			std::vector<float> values(packed.size() - count);
+			kernel(packed.data() + count, values.data(), values.size());
+
+			for (std::size_t i = 0; i < values.size(); ++i)
+			{
+				assert(values[i] == float(Float(char(packed[count + i]))));
+			}
+		}
+	}
+}
+
+float FromBits(std::uint32_t bits)
+{
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/// Nearest Float found by searching the decoded values, independent of the bit manipulation in the encoders.
+std::uint8_t ReferenceEncode(double value)
+{
+	const std::uint8_t sign = std::signbit(value) ? 0x80 : 0x00;
+	const double magnitude = std::fabs(value);
+
+	if (std::isnan(value) || magnitude >= 31.0)
+	{
+		return sign | 0x7F;
+	}
+
+	if (magnitude <= 0.125)
+	{
+		return sign;
+	}
+
+	/// Positive patterns are ordered like their values, find the last one not above magnitude.
+	unsigned low = 0;
+	unsigned high = 0x7F;
+	while (low < high)
+	{
+		const unsigned middle = (low + high + 1) / 2;
+		if (float(Float(static_cast<char>(middle))) <= magnitude)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	const double below = magnitude - float(Float(static_cast<char>(low)));
+	const double above = float(Float(static_cast<char>(low + 1))) - magnitude;
+	const bool roundUp = above < below || (above == below && (low & 1u));
+
+	return sign | static_cast<std::uint8_t>(roundUp ? low + 1 : low);
+}
+
+void TestEncodeNearest()
+{
+	for (int i = 0; i < 256; ++i)
+	{
+		assert(Float::from_float(float(Float(static_cast<char>(i)))).bits() == i);
+	}
+
+	/// Every float exponent and sign, every upper mantissa bit and the low bits that decide rounding.
+	const std::uint32_t lowBits[] = { 0x000, 0x001, 0x7FF, 0x800, 0x801, 0xFFF };
+	for (std::uint32_t upper = 0; upper < (1u << 20); ++upper)
+	{
+		for (std::uint32_t low : lowBits)
+		{
+			const float value = FromBits((upper << 12) | low);
+			assert(Float::from_float(value).bits() == ReferenceEncode(value));
+		}
+	}
+
+	assert(Float::from_float(0.f).bits() == 0x00);
+	assert(Float::from_float(-0.f).bits() == 0x80);
+	assert(Float::from_float(0.01f).bits() == 0x00);
+	assert(Float::from_float(1000.f).bits() == 0x7F);
+	assert(Float::from_float(-std::numeric_limits<float>::infinity()).bits() == 0xFF);
+	/// Halfway between 1 and 1.0625 goes to the even 1, halfway between 1.0625 and 1.125 to the even 1.125.
+	assert(Float::from_float(1.03125f).bits() == 0x30);
+	assert(Float::from_float(1.09375f).bits() == 0x32);
+}
+
+/// A stride of 1 checks every float bit pattern, larger strides a spread out sample of them.
+void TestEncodeKernels(std::uint32_t stride)
+{
+	std::vector<EncodeKernel> kernels;
+	if (Cpu::Features() & Cpu::SSE41)
+	{
+		kernels.push_back(EncodeFloatsSse41);
+	}
+	if (Cpu::Features() & Cpu::AVX2)
+	{
+		kernels.push_back(EncodeFloatsAvx2);
+	}
+
+	/// Chunks have a length that is not a multiple of the vector width, to also cover the tails.
+	const std::size_t CHUNK = (1u << 20) + 13;
+	std::vector<float> values(CHUNK);
+	std::vector<std::uint8_t> expected(CHUNK);
+	std::vector<std::uint8_t> packed(CHUNK);
+
+	for (RoundingMode mode : { RoundingMode::Nearest, RoundingMode::Stochastic })
+	{
+		for (std::uint64_t first = 0; first < (1ull << 32); first += CHUNK * stride)
+		{
+			const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(CHUNK, ((1ull << 32) - first + stride - 1) / stride));
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				values[i] = FromBits(static_cast<std::uint32_t>(first + i * stride));
+			}
+
+			EncodeFloatsScalar(values.data(), expected.data(), count, mode, first);
+
+			for (EncodeKernel kernel : kernels)
+			{
+				kernel(values.data(), packed.data(), count, mode, first);
+				assert(std::memcmp(packed.data(), expected.data(), count) == 0);
+			}
+		}
+	}
+}
+
+void TestEncodeStochastic()
+{
+	/// Always one of the two neighbours, and unbiased on average.
+	const float value = 1.2f;
+	const std::size_t COUNT = 1 << 20;
+
+	std::vector<float> values(COUNT, value);
+	std::vector<std::uint8_t> packed(COUNT);
+	EncodeFloats(values.data(), packed.data(), COUNT, RoundingMode::Stochastic, 42);
+
+	const std::uint8_t below = Float::from_float(1.1875f).bits();
+	double sum = 0.0;
+	for (std::uint8_t bits : packed)
+	{
+		assert(bits == below || bits == below + 1);
+		sum += float(Float(static_cast<char>(bits)));
+	}
+
+	assert(std::fabs(sum / COUNT - value) < 1e-3);
+}
+
+void TestOperations()
+{
+	for (int lhs = 0; lhs < 256; ++lhs)
+	{
+		for (int rhs = 0; rhs < 256; ++rhs)
+		{
+			const Float a(static_cast<char>(lhs));
+			const Float b(static_cast<char>(rhs));
+			const double x = float(a);
+			const double y = float(b);
+
+			assert((a + b).bits() == ReferenceEncode(x + y));
+			assert((a - b).bits() == ReferenceEncode(x - y));
+			assert((a * b).bits() == ReferenceEncode(x * y));
+			assert((a / b).bits() == ReferenceEncode(x / y));
+
+			assert((a < b) == (x < y));
+			assert((a <= b) == (x <= y));
+			assert((a == b) == (x == y));
+		}
+	}
+
+	/// Batched operations match the operators, also in place.
+	std::vector<std::uint8_t> lhs(1000);
+	std::vector<std::uint8_t> rhs(1000);
+	std::vector<std::uint8_t> result(1000);
+	for (std::size_t i = 0; i < lhs.size(); ++i)
+	{
+		lhs[i] = static_cast<std::uint8_t>(i * 7);
+		rhs[i] = static_cast<std::uint8_t>(i * 13 + 5);
+	}
+
+	FloatOps::Apply(FloatOps::Operation::Multiply, lhs.data(), rhs.data(), result.data(), lhs.size());
+	for (std::size_t i = 0; i < lhs.size(); ++i)
+	{
+		assert(result[i] == (Float(static_cast<char>(lhs[i])) * Float(static_cast<char>(rhs[i]))).bits());
+	}
+
+	FloatOps::Apply(FloatOps::Operation::Add, result.data(), rhs.data(), result.data(), lhs.size());
+
+	/// Float with Float stays in the format, mixed with float it is float arithmetic.
+	static_assert(std::is_same<decltype(Float() + Float()), Float>::value, "Float arithmetic is table driven");
+	static_assert(std::is_same<decltype(Float() + 1.f), float>::value, "Mixed arithmetic converts to float");
+	assert(Float::from_float(1.5f) + 0.25f == 1.75f);
+
+	const std::uint8_t ones[4] = { 0x30, 0x30, 0x30, 0x30 };
+	assert(float(FloatOps::Sum(ones, 4)) == 4.f);
+	assert(float(FloatOps::Dot(ones, ones, 4)) == 4.f);
+	assert(float(Float::from_float(3.f) - Float::from_float(3.f)) == 0.125f);
+	assert(float(-Float::from_float(2.5f)) == -2.5f);
+}
+
+/// Nearest pattern found by searching the decoded values, the MiniFloat counterpart of ReferenceEncode.
+template <typename Format>
+typename Format::Storage ReferenceMiniFloatEncode(float value)
+{
+	typedef typename Format::Storage Storage;
+
+	const unsigned sign = std::signbit(value) ? Format::SIGN_MASK : 0u;
+	const double magnitude = std::fabs(static_cast<double>(value));
+	const double max = float(Format::from_bits(static_cast<Storage>(Format::MAX_FINITE)));
+	const double maxUlp = max - float(Format::from_bits(static_cast<Storage>(Format::MAX_FINITE - 1)));
+
+	if (std::isnan(value))
+	{
+		return static_cast<Storage>(sign | Format::NAN_PATTERN);
+	}
+
+	if (magnitude >= max)
+	{
+		/// Past the largest value, ties go to the even infinity pattern.
+		const bool overflow = Format::KIND == MiniFloatKind::Ieee && magnitude >= max + maxUlp / 2;
+		return static_cast<Storage>(sign | (overflow ? Format::INFINITY_PATTERN : Format::MAX_FINITE));
+	}
+
+	if (magnitude <= float(Format::from_bits(0)))
+	{
+		return static_cast<Storage>(sign);
+	}
+
+	unsigned low = 0;
+	unsigned high = Format::MAX_FINITE;
+	while (low < high)
+	{
+		const unsigned middle = (low + high + 1) / 2;
+		if (float(Format::from_bits(static_cast<Storage>(middle))) <= magnitude)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	const double below = magnitude - float(Format::from_bits(static_cast<Storage>(low)));
+	const double above = float(Format::from_bits(static_cast<Storage>(low + 1))) - magnitude;
+	const bool roundUp = above < below || (above == below && (low & 1u));
+
+	return static_cast<Storage>(sign | (roundUp ? low + 1 : low));
+}
+
+template <typename Format>
+void TestMiniFloatFormat()
+{
+	typedef typename Format::Storage Storage;
+
+	/// Every pattern that is a number decodes to a value that encodes back to it.
+	for (unsigned bits = 0; bits < (1u << Format::BITS); ++bits)
+	{
+		const Format number = Format::from_bits(static_cast<Storage>(bits));
+		const float value = number;
+
+		assert(number.is_nan() == std::isnan(value));
+		assert(number.is_nan() || Format::from_float(value).bits() == bits);
+		assert(value == Format::DecodeValue(bits) || number.is_nan());
+	}
+
+	const std::uint32_t lowBits[] = { 0x000, 0x001, 0x7FF, 0x800, 0x801, 0xFFF };
+	for (std::uint32_t upper = 0; upper < (1u << 20); upper += 5)
+	{
+		for (std::uint32_t low : lowBits)
+		{
+			const float value = FromBits((upper << 12) | low);
+			const Storage bits = Format::from_float(value).bits();
+			const Storage expected = ReferenceMiniFloatEncode<Format>(value);
+
+			assert(bits == expected || (Format::from_bits(bits).is_nan() && Format::from_bits(expected).is_nan()));
+		}
+	}
+
+	/// The bulk functions match the scalar ones.
+	std::vector<float> values(1000);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		values[i] = (static_cast<float>(i) - 500.f) * 0.37f;
+	}
+
+	std::vector<Storage> packed(values.size());
+	std::vector<float> decoded(values.size());
+	EncodeMiniFloats<Format>(values.data(), packed.data(), values.size());
+	DecodeMiniFloats<Format>(packed.data(), decoded.data(), packed.size());
+
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		assert(packed[i] == Format::from_float(values[i]).bits());
+		assert(decoded[i] == float(Format::from_bits(packed[i])));
+	}
+}
+
+void TestMiniFloats()
+{
+	TestMiniFloatFormat<Float8>();
+	TestMiniFloatFormat<E4M3>();
+	TestMiniFloatFormat<E5M2>();
+	TestMiniFloatFormat<Half>();
+	TestMiniFloatFormat<BFloat16>();
+
+	for (int i = 0; i < 256; ++i)
+	{
+		assert(float(Float8::from_bits(static_cast<std::uint8_t>(i))) == float(Float(static_cast<char>(i))));
+	}
+
+	/// The generic stochastic rounding is the one of the Float8 vector kernels.
+	std::vector<float> values(4099);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		values[i] = static_cast<float>(i) * 0.0071f;
+	}
+
+	std::vector<std::uint8_t> vectorized(values.size());
+	EncodeMiniFloats<Float8>(values.data(), vectorized.data(), values.size(), RoundingMode::Stochastic, 7);
 
-	//TODO
-	assert((Float(0x08).mantissa() - 1.5f) < epsilon);
-	assert((Float(0x07).mantissa() - 2.0f) < epsilon);
-	assert((Float(0x06).mantissa() - 1.375f) < epsilon);
-	assert((Float(0x05).mantissa() - 1.3125f) < epsilon);
-	assert((Float(0x04).mantissa() - 1.25f) < epsilon);
-	assert((Float(0x03).mantissa() - 1.1875f) < epsilon);
-	assert((Float(0x02).mantissa() - 1.125f) < epsilon);
-	assert((Float(0x01).mantissa() - 1.0625f) < epsilon);
-	assert((Float(0x00).mantissa() - 1.f) < epsilon);
+	const FloatDetail::StochasticKey key = FloatDetail::MakeStochasticKey(7);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		assert(Float8::from_float_stochastic(values[i], FloatDetail::StochasticBits(i, key)).bits() == vectorized[i]);
+	}
+
+	assert(float(E4M3::from_bits(0x7E)) == 448.f);
+	assert(E4M3::from_bits(0x7F).is_nan());
+	assert(float(E4M3::from_bits(0x01)) == std::ldexp(1.f, -9));
+	assert(E4M3::from_float(1.f).bits() == 0x38);
+	assert(E4M3::from_float(1000.f).bits() == 0x7E);
+	assert(E4M3::from_float(-std::numeric_limits<float>::infinity()).bits() == 0xFE);
+
+	assert(float(E5M2::from_bits(0x7B)) == 57344.f);
+	assert(E5M2::from_float(1.f).bits() == 0x3C);
+	assert(E5M2::from_float(1e6f).bits() == 0x7C);
+
+	assert(Half::from_float(1.f).bits() == 0x3C00);
+	assert(Half::from_float(65504.f).bits() == 0x7BFF);
+	assert(Half::from_float(65520.f).bits() == 0x7C00);
+	assert(Half::from_float(std::ldexp(1.f, -24)).bits() == 0x0001);
+
+	assert(BFloat16::from_float(1.f).bits() == 0x3F80);
+	assert(BFloat16::from_float(1.f + std::ldexp(1.f, -8)).bits() == 0x3F80);
+	assert(BFloat16::from_float(1.f + 3 * std::ldexp(1.f, -8)).bits() == 0x3F82);
 }
 
-int main()
+/// Appends values in two parts and checks the column sums against the stored and the original values.
+void TestColumnSums(const std::vector<float>& values, const std::vector<PackedSumKernel>& kernels)
 {
+	for (RoundingMode mode : { RoundingMode::Nearest, RoundingMode::Stochastic })
+	{
+		FloatColumn column(mode, 11);
+		column.Append(values.data(), 1000);
+		column.Append(values.data() + 1000, values.size() - 1000);
+		assert(column.Size() == values.size());
+
+		std::vector<float> stored(values.size());
+		column.Decode(0, stored.size(), stored.data());
+
+		/// Every Float is a multiple of 2^-7 below 32, so the double sum of the stored values is exact.
+		/// The original floats are not, they are summed with Kahan in double, as the quantization error is.
+		double storedSum = 0.0;
+		double originalSum = 0.0;
+		double originalCompensator = 0.0;
+		double magnitudes = 0.0;
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			assert(stored[i] == float(Float(static_cast<char>(column.Data()[i]))));
+			storedSum += stored[i];
+
+			const double compensatedNumber = static_cast<double>(values[i]) - originalCompensator;
+			const double temporarySum = originalSum + compensatedNumber;
+			originalCompensator = (temporarySum - originalSum) - compensatedNumber;
+			originalSum = temporarySum;
+
+			magnitudes += std::fabs(values[i]) + std::fabs(static_cast<double>(values[i]) - stored[i]);
+		}
+		originalSum -= originalCompensator;
+
+		/// Both Kahan sums in double err by at most (2u + n u^2) times their sum of magnitudes, u = 2^-53.
+		const double u = std::ldexp(1.0, -53);
+		const double n = static_cast<double>(values.size());
+		const double slack = (2.0 * u + n * u * u) * magnitudes;
+
+		/// The float lanes lose the small values without the compensation, hundreds of ULPs of the sum.
+		const float roundedSum = std::fabs(static_cast<float>(storedSum));
+		const double ulp = static_cast<double>(std::nextafter(roundedSum, std::numeric_limits<float>::infinity())) - roundedSum;
+
+		const ColumnSum sum = column.Sum();
+		assert(std::fabs(sum.Sum - storedSum) <= sum.SummationErrorBound);
+		assert(std::fabs(sum.Sum - storedSum) <= 2.0 * ulp);
+		assert(std::fabs(sum.Sum + sum.QuantizationError - originalSum) <= sum.SummationErrorBound + slack);
+
+		for (PackedSumKernel kernel : kernels)
+		{
+			const double kernelSum = kernel(column.Data(), column.Size());
+			assert(std::fabs(kernelSum - storedSum) <= sum.SummationErrorBound);
+			assert(std::fabs(kernelSum - storedSum) <= 2.0 * ulp);
+		}
+	}
+}
+
+void TestColumn()
+{
+	std::vector<PackedSumKernel> kernels = { SumPackedFloatsScalar };
+	if (Cpu::Features() & Cpu::SSSE3)
+	{
+		kernels.push_back(SumPackedFloatsSsse3);
+	}
+	if (Cpu::Features() & Cpu::AVX2)
+	{
+		kernels.push_back(SumPackedFloatsAvx2);
+	}
+
+	/// Long enough for several kernel blocks, with a tail that misses every vector width.
+	const std::size_t length = 3 * (1 << 16) + 45;
+
+	std::vector<float> values(length);
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		values[i] = std::sin(static_cast<float>(i) * 0.37f) * 20.f;
+	}
+	TestColumnSums(values, kernels);
+
+	/// In every kernel block a prefix of 31s takes a float lane past 2^20, where its ULP is 0.125,
+	/// then values near 0.13 follow, which a naive sum would round to 0.125 each time. The vector lanes
+	/// see at most 4096 values of a block, their sums stay multiples of 2^-7 below 2^17 and exact anyway.
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		values[i] = i % (1 << 16) < 40000 ? 31.f : 0.13f;
+	}
+	TestColumnSums(values, kernels);
+
+	FloatColumn empty;
+	assert(empty.Sum().Sum == 0.0);
+}
+
+/// Pass --exhaustive to check the encode kernels on all 2^32 float bit patterns, which takes a while,
+/// and --benchmark to time the kernels afterwards.
+int main(int argc, char** argv)
+{
+	bool exhaustive = false;
+	bool benchmark = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		exhaustive = exhaustive || std::string(argv[i]) == "--exhaustive";
+		benchmark = benchmark || std::string(argv[i]) == "--benchmark";
+	}
+
 	TestSign();
 	TestBiasedExponent();
 	TestActualExponent();
 	TestMantissa();
+	TestConversion();
+	TestBulkDecode();
+	TestEncodeNearest();
+	TestEncodeKernels(exhaustive ? 1 : 97);
+	TestEncodeStochastic();
+	TestMiniFloats();
+	TestOperations();
+	TestColumn();
+
+	std::cout << "Decode kernel: " << DecodeKernelName(SelectDecodeKernel()) << std::endl;
+	std::cout << "Encode kernel: " << EncodeKernelName(SelectEncodeKernel()) << std::endl;
+	std::cout << "Column sum kernel: " << PackedSumKernelName(SelectPackedSumKernel()) << std::endl;
+	std::cout << std::endl;
+
+	const unsigned failures = CheckFloatProperties();
+	if (failures != 0)
+	{
+		std::cout << failures << " property checks failed" << std::endl;
+		return 1;
+	}
+
+	if (benchmark)
+	{
+		std::cout << std::endl;
+		RunCodecBenchmark();
+	}
 
 	return 0;
-}
\ No newline at end of file
+}
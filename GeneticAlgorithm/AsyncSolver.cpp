@@ -0,0 +1,274 @@
+#include "AsyncSolver.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	/// Amount of genes worth a task of its own. Smaller levels evolve a whole generation in one task.
+	static const unsigned long long MIN_CHUNK_GENES = 1ull << 20;
+};
+
+std::shared_ptr<SolveRun> SolveRun::Start(Executor& executor,
+	const std::shared_ptr<Game>& game,
+	const SolveParameters& parameters)
+{
+	std::shared_ptr<SolveRun> run(new SolveRun(executor, game, parameters));
+	run->ScheduleInitialization();
+	return run;
+}
+
+std::shared_ptr<SolveRun> SolveRun::Create(Executor& executor,
+	const std::shared_ptr<Game>& game,
+	const SolveParameters& parameters)
+{
+	return std::shared_ptr<SolveRun>(new SolveRun(executor, game, parameters));
+}
+
+bool SolveRun::Advance()
+{
+	if (Stats().Status != SolveStatus::Running)
+	{
+		return false;
+	}
+
+	if (m_Initializing)
+	{
+		m_Population.InitializeRange(0, m_Population.Size());
+	}
+	else
+	{
+		SolveStatus status = CheckLimits();
+		if (status != SolveStatus::Running)
+		{
+			Finish(status);
+			return false;
+		}
+
+		m_Population.BeginGeneration();
+		m_Population.EvolveRange(m_Population.ElitesCount(), m_Population.Size());
+	}
+
+	return CompleteGeneration();
+}
+
+SolveRun::SolveRun(Executor& executor, const std::shared_ptr<Game>& game, const SolveParameters& parameters)
+	: m_Executor(executor)
+	, m_Parameters(parameters)
+	, m_Started(std::chrono::steady_clock::now())
+	, m_Cancelled(false)
+	, m_PendingChunks(0)
+	, m_Initializing(true)
+	, m_Done(false)
+	, m_Stats()
+	, m_Best()
+{
+	m_Population.SetSeeding(parameters.Seeding);
+	m_Population.Prepare(parameters.PopulationSize, parameters.ChromosomeSize, parameters.SelectionRatio, game);
+	m_Stats.Status = SolveStatus::Running;
+}
+
+std::future<GenerationStats> SolveRun::NextGeneration()
+{
+	std::promise<GenerationStats> promise;
+	std::future<GenerationStats> future = promise.get_future();
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (m_Stats.Status != SolveStatus::Running)
+	{
+		promise.set_value(m_Stats);
+	}
+	else
+	{
+		m_Waiting.push_back(std::move(promise));
+	}
+
+	return future;
+}
+
+Population::Chromosome SolveRun::Best() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Best;
+}
+
+GenerationStats SolveRun::Stats() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Stats;
+}
+
+void SolveRun::Cancel()
+{
+	m_Cancelled = true;
+}
+
+GenerationStats SolveRun::Wait()
+{
+	assert(!m_Executor.IsPoolThread());
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Finished.wait(lock, [this]() { return m_Done; });
+	return m_Stats;
+}
+
+void SolveRun::ScheduleInitialization()
+{
+	RunChunks(0, m_Population.Size(), &Population::InitializeRange);
+}
+
+void SolveRun::ScheduleGeneration()
+{
+	SolveStatus status = CheckLimits();
+	if (status != SolveStatus::Running)
+	{
+		Finish(status);
+		return;
+	}
+
+	m_Population.BeginGeneration();
+	RunChunks(m_Population.ElitesCount(), m_Population.Size(), &Population::EvolveRange);
+}
+
+void SolveRun::RunChunks(Population::SizeType start,
+	Population::SizeType end,
+	void (Population::*routine)(Population::SizeType, Population::SizeType))
+{
+	const Population::SizeType count = end - start;
+	const unsigned long long genes = static_cast<unsigned long long>(count) * m_Parameters.ChromosomeSize;
+
+	unsigned long long chunks = std::min<unsigned long long>(genes / MIN_CHUNK_GENES, m_Executor.ThreadsCount());
+	chunks = std::max<unsigned long long>(std::min<unsigned long long>(chunks, count), 1);
+
+	const Population::SizeType chunkSize = static_cast<Population::SizeType>((count + chunks - 1) / chunks);
+
+	/// The chunk finishing last completes the phase, so no thread ever blocks waiting for the others.
+	m_PendingChunks = static_cast<unsigned>(chunks);
+
+	std::shared_ptr<SolveRun> self = shared_from_this();
+	for (unsigned long long c = 0; c < chunks; ++c)
+	{
+		Population::SizeType chunkStart = std::min(static_cast<Population::SizeType>(start + c * chunkSize), end);
+		Population::SizeType chunkEnd = std::min(static_cast<Population::SizeType>(chunkStart + chunkSize), end);
+
+		m_Executor.Post([self, routine, chunkStart, chunkEnd]() {
+			(self->m_Population.*routine)(chunkStart, chunkEnd);
+
+			if (--self->m_PendingChunks == 0 && self->CompleteGeneration())
+			{
+				/// Re-queue instead of continuing inline, so other runs on the executor get their turn.
+				self->m_Executor.Post([self]() {
+					self->ScheduleGeneration();
+				});
+			}
+		});
+	}
+}
+
+bool SolveRun::CompleteGeneration()
+{
+	unsigned long long evaluated = m_Population.Size();
+	if (m_Initializing)
+	{
+		m_Population.FinishInitialization();
+	}
+	else
+	{
+		m_Population.EndGeneration();
+		evaluated -= m_Population.ElitesCount();
+	}
+	m_Initializing = false;
+
+	const bool solved = m_Population.FoundSolution();
+
+	GenerationStats stats;
+	std::vector<std::promise<GenerationStats>> waiting;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		++m_Stats.Generation;
+		m_Stats.Fittest = m_Population.GetFittest().Fitness;
+		m_Stats.Evaluations += evaluated;
+		m_Stats.Elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_Started);
+		m_Best = m_Population.GetFittest();
+
+		if (solved)
+		{
+			m_Stats.Status = SolveStatus::Solved;
+		}
+
+		stats = m_Stats;
+		waiting.swap(m_Waiting);
+	}
+
+	for (std::promise<GenerationStats>& promise : waiting)
+	{
+		promise.set_value(stats);
+	}
+
+	if (m_Parameters.OnGeneration)
+	{
+		m_Parameters.OnGeneration(stats);
+	}
+
+	if (solved)
+	{
+		Finish(SolveStatus::Solved);
+		return false;
+	}
+
+	return true;
+}
+
+SolveStatus SolveRun::CheckLimits() const
+{
+	if (m_Cancelled)
+	{
+		return SolveStatus::Cancelled;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	const SolveBudget& budget = m_Parameters.Budget;
+	if (budget.WallTime.count() > 0 && std::chrono::steady_clock::now() - m_Started >= budget.WallTime)
+	{
+		return SolveStatus::WallTimeExceeded;
+	}
+
+	if (budget.Evaluations > 0 && m_Stats.Evaluations >= budget.Evaluations)
+	{
+		return SolveStatus::EvaluationsExceeded;
+	}
+
+	return SolveStatus::Running;
+}
+
+void SolveRun::Finish(SolveStatus status)
+{
+	GenerationStats stats;
+	std::vector<std::promise<GenerationStats>> waiting;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_Stats.Status = status;
+		m_Stats.Elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_Started);
+
+		stats = m_Stats;
+		waiting.swap(m_Waiting);
+	}
+
+	for (std::promise<GenerationStats>& promise : waiting)
+	{
+		promise.set_value(stats);
+	}
+
+	if (m_Parameters.OnFinished)
+	{
+		m_Parameters.OnFinished(stats);
+	}
+
+	/// Notified under the lock, a waiter may destroy the run as soon as Wait returns.
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Done = true;
+	m_Finished.notify_all();
+}
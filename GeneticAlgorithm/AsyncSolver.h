@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Population.h"
+#include "Executor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+enum class SolveStatus
+{
+	Running,
+	Solved,
+	Cancelled,
+	WallTimeExceeded,
+	EvaluationsExceeded
+};
+
+/// Limits of a single run. Zero means unlimited.
+struct SolveBudget
+{
+	std::chrono::milliseconds WallTime;
+	unsigned long long Evaluations;
+};
+
+struct GenerationStats
+{
+	/// Generation 1 is the randomly initialized population.
+	long long Generation;
+	Population::Fitness Fittest;
+	/// Fitness evaluations since the run started.
+	unsigned long long Evaluations;
+	std::chrono::milliseconds Elapsed;
+	SolveStatus Status;
+};
+
+struct SolveParameters
+{
+	Population::SizeType PopulationSize;
+	Population::SizeType ChromosomeSize;
+	float SelectionRatio;
+	SolveBudget Budget;
+	Population::Seeding Seeding;
+	/// Called on an executor thread after every generation.
+	std::function<void(const GenerationStats&)> OnGeneration;
+	/// Called on an executor thread once the run stops for any reason.
+	std::function<void(const GenerationStats&)> OnFinished;
+};
+
+/// A level solve that advances one generation at a time as tasks on a shared Executor,
+/// so many runs can make progress on the same threads.
+/// Every generation is split into chunks of roughly MIN_CHUNK_GENES genes, small levels run as a single task.
+/// Cancellation and budgets are checked between generations.
+/// The executor has to outlive the run, a run whose tasks were dropped never stops.
+class SolveRun : public std::enable_shared_from_this<SolveRun>
+{
+public:
+	static std::shared_ptr<SolveRun> Start(Executor& executor, const std::shared_ptr<Game>& game, const SolveParameters& parameters);
+
+	/// Creates a run without scheduling it, the caller drives it through Advance.
+	static std::shared_ptr<SolveRun> Create(Executor& executor, const std::shared_ptr<Game>& game, const SolveParameters& parameters);
+
+	/// Runs the next generation on the calling thread. Returns false once the run has stopped.
+	/// Must not be mixed with a run created through Start.
+	bool Advance();
+
+	SolveRun(const SolveRun& rhs) = delete;
+	SolveRun& operator=(const SolveRun& rhs) = delete;
+
+	/// Becomes ready when the next generation completes.
+	/// Once the run has stopped the future is ready immediately with the final stats.
+	std::future<GenerationStats> NextGeneration();
+
+	/// Copy of the fittest chromosome of the last completed generation.
+	Population::Chromosome Best() const;
+
+	GenerationStats Stats() const;
+
+	/// Asks the run to stop before starting the next generation.
+	void Cancel();
+
+	/// Blocks until the run stops and OnFinished has returned, then returns the final stats.
+	/// Must not be called from an executor thread, e.g. from OnGeneration or OnFinished:
+	/// the run needs those threads to stop, once all of them wait it never does.
+	GenerationStats Wait();
+
+private:
+	SolveRun(Executor& executor, const std::shared_ptr<Game>& game, const SolveParameters& parameters);
+
+	void ScheduleInitialization();
+	void ScheduleGeneration();
+	void RunChunks(Population::SizeType start, Population::SizeType end, void (Population::*routine)(Population::SizeType, Population::SizeType));
+	/// Publishes the finished generation, returns false if the run stopped.
+	bool CompleteGeneration();
+	SolveStatus CheckLimits() const;
+	void Finish(SolveStatus status);
+
+	Executor& m_Executor;
+	SolveParameters m_Parameters;
+	Population m_Population;
+	std::chrono::steady_clock::time_point m_Started;
+	std::atomic<bool> m_Cancelled;
+	/// Chunks of the current phase still running.
+	std::atomic<unsigned> m_PendingChunks;
+	bool m_Initializing;
+
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_Finished;
+	/// Set once the final callbacks have run, the status alone is final before OnFinished is called.
+	bool m_Done;
+	GenerationStats m_Stats;
+	Population::Chromosome m_Best;
+	std::vector<std::promise<GenerationStats>> m_Waiting;
+};
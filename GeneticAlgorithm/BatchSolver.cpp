@@ -0,0 +1,261 @@
+#include "BatchSolver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	/// Levels below this amount of genes are packed, larger ones get chunked over the executor.
+	static const unsigned long long SMALL_LEVEL_GENES = 1ull << 20;
+	/// Upper bound of genes stepped by one pack task per round.
+	static const unsigned long long PACK_GENES = 1ull << 22;
+
+	/// One decision per frame over the whole level width, same as flappy.cpp.
+	Population::SizeType ChromosomeSizeFor(const Game& game)
+	{
+		return static_cast<Population::SizeType>(std::floor(game.Level.width / game.HorizontalVelocity));
+	}
+};
+
+BatchSolver::BatchSolver(Executor& executor, const BatchParameters& parameters)
+	: m_Executor(executor)
+	, m_Parameters(parameters)
+	, m_MaxLanes(executor.ThreadsCount() * 2)
+	, m_PendingGenes(0)
+	, m_Submitted(0)
+	, m_Reported(0)
+	, m_ActiveLanes(0)
+	, m_Cancelled(false)
+{
+}
+
+BatchSolver::~BatchSolver()
+{
+	assert(!m_Executor.IsPoolThread());
+
+	Cancel();
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_CondVar.wait(lock, [this]() { return m_ActiveLanes == 0; });
+}
+
+void BatchSolver::Submit(const std::vector<std::shared_ptr<Game>>& games)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	for (const std::shared_ptr<Game>& game : games)
+	{
+		QueuedLevel level;
+		level.Index = m_Submitted++;
+		level.LevelGame = game;
+		level.Genes = static_cast<unsigned long long>(m_Parameters.PopulationSize) * ChromosomeSizeFor(*game);
+
+		m_Pending.push_back(level);
+		m_PendingGenes += level.Genes;
+	}
+
+	if (m_Cancelled)
+	{
+		ReportPendingAsCancelled();
+		return;
+	}
+
+	StartLanes();
+}
+
+bool BatchSolver::NextResult(BatchResult& result)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_CondVar.wait(lock, [this]() { return !m_Results.empty() || m_Reported == m_Submitted; });
+
+	if (m_Results.empty())
+	{
+		return false;
+	}
+
+	result = std::move(m_Results.front());
+	m_Results.pop_front();
+	return true;
+}
+
+void BatchSolver::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_Cancelled = true;
+	ReportPendingAsCancelled();
+
+	for (auto& running : m_Running)
+	{
+		running.second->Cancel();
+	}
+}
+
+SolveParameters BatchSolver::ParametersFor(const Game& game) const
+{
+	SolveParameters parameters;
+	parameters.PopulationSize = m_Parameters.PopulationSize;
+	parameters.ChromosomeSize = ChromosomeSizeFor(game);
+	parameters.SelectionRatio = m_Parameters.SelectionRatio;
+	parameters.Budget = m_Parameters.Budget;
+	parameters.Seeding = m_Parameters.Seeding;
+	return parameters;
+}
+
+void BatchSolver::StartLanes()
+{
+	while (!m_Cancelled && m_ActiveLanes < m_MaxLanes && !m_Pending.empty())
+	{
+		++m_ActiveLanes;
+
+		if (m_Pending.front().Genes < SMALL_LEVEL_GENES)
+		{
+			std::shared_ptr<Pack> pack = std::make_shared<Pack>();
+			pack->Genes = 0;
+			/// This lane is already counted as active, so it is one of the free ones plus one.
+			FillPack(*pack, PackLimit(m_MaxLanes - m_ActiveLanes + 1));
+
+			m_Executor.Post([this, pack]() {
+				RunPack(pack);
+			});
+			continue;
+		}
+
+		QueuedLevel level = m_Pending.front();
+		m_Pending.pop_front();
+		m_PendingGenes -= level.Genes;
+
+		SolveParameters parameters = ParametersFor(*level.LevelGame);
+
+		/// Runs on an executor thread. m_Mutex is held here until the run is registered,
+		/// so even a run solved right away finds itself in m_Running.
+		const std::size_t index = level.Index;
+		parameters.OnFinished = [this, index](const GenerationStats&) {
+			std::shared_ptr<SolveRun> run;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				run = m_Running[index];
+			}
+
+			Report(index, run);
+			ReleaseLane();
+		};
+
+		m_Running[index] = SolveRun::Start(m_Executor, level.LevelGame, parameters);
+	}
+}
+
+void BatchSolver::FillPack(Pack& pack, unsigned long long limit)
+{
+	while (!m_Cancelled && !m_Pending.empty())
+	{
+		const QueuedLevel& level = m_Pending.front();
+		if (level.Genes >= SMALL_LEVEL_GENES || (!pack.Runs.empty() && pack.Genes + level.Genes > limit))
+		{
+			break;
+		}
+
+		PackedRun packed;
+		packed.Index = level.Index;
+		packed.Run = SolveRun::Create(m_Executor, level.LevelGame, ParametersFor(*level.LevelGame));
+		packed.Genes = level.Genes;
+
+		m_Running[packed.Index] = packed.Run;
+		pack.Runs.push_back(packed);
+		pack.Genes += packed.Genes;
+
+		m_PendingGenes -= level.Genes;
+		m_Pending.pop_front();
+	}
+}
+
+unsigned long long BatchSolver::PackLimit(unsigned lanes) const
+{
+	const unsigned long long share = (m_PendingGenes + lanes - 1) / lanes;
+	return std::min(share, PACK_GENES);
+}
+
+void BatchSolver::ReportPendingAsCancelled()
+{
+	for (const QueuedLevel& level : m_Pending)
+	{
+		BatchResult result;
+		result.Index = level.Index;
+		result.Best = Population::Chromosome();
+		result.Stats = GenerationStats();
+		result.Stats.Status = SolveStatus::Cancelled;
+
+		m_Results.push_back(result);
+		++m_Reported;
+	}
+	m_Pending.clear();
+	m_PendingGenes = 0;
+
+	m_CondVar.notify_all();
+}
+
+void BatchSolver::RunPack(const std::shared_ptr<Pack>& pack)
+{
+	/// One generation of every level in the pack, then the pack goes back in the queue.
+	auto packed = pack->Runs.begin();
+	while (packed != pack->Runs.end())
+	{
+		if (packed->Run->Advance())
+		{
+			++packed;
+			continue;
+		}
+
+		Report(packed->Index, packed->Run);
+		pack->Genes -= packed->Genes;
+		packed = pack->Runs.erase(packed);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		/// Free lanes take the pending levels first, this pack is only topped up with what
+		/// its own share of the rest is, which is up to PACK_GENES once every lane is busy.
+		StartLanes();
+		FillPack(*pack, PackLimit(m_MaxLanes - m_ActiveLanes + 1));
+
+		if (pack->Runs.empty())
+		{
+			--m_ActiveLanes;
+			StartLanes();
+			m_CondVar.notify_all();
+			return;
+		}
+	}
+
+	m_Executor.Post([this, pack]() {
+		RunPack(pack);
+	});
+}
+
+void BatchSolver::Report(std::size_t index, const std::shared_ptr<SolveRun>& run)
+{
+	BatchResult result;
+	result.Index = index;
+	result.Best = run->Best();
+	result.Stats = run->Stats();
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_Running.erase(index);
+	m_Results.push_back(std::move(result));
+	++m_Reported;
+
+	m_CondVar.notify_all();
+}
+
+void BatchSolver::ReleaseLane()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	--m_ActiveLanes;
+	StartLanes();
+
+	m_CondVar.notify_all();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "AsyncSolver.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct BatchParameters
+{
+	Population::SizeType PopulationSize;
+	float SelectionRatio;
+	/// Applied to every level separately.
+	SolveBudget Budget;
+	Population::Seeding Seeding;
+};
+
+struct BatchResult
+{
+	/// Position of the level in the order it was submitted.
+	std::size_t Index;
+	Population::Chromosome Best;
+	GenerationStats Stats;
+};
+
+/// Solves many levels on one shared Executor.
+/// Large levels run as their own SolveRun, chunked over all threads.
+/// Levels below SMALL_LEVEL_GENES are packed together and stepped back to back by a single task,
+/// so thousands of tiny populations do not pay a task round trip per generation each.
+/// The pending small levels are spread over all free lanes first, a pack only grows up to
+/// PACK_GENES once every lane is busy, so even a batch of tiny levels keeps every thread working.
+/// At most twice the executor's threads worth of runs / packs are in flight,
+/// which bounds the memory held by populations that are not being worked on.
+class BatchSolver
+{
+public:
+	BatchSolver(Executor& executor, const BatchParameters& parameters);
+	/// Cancels whatever is still running and waits for it to stop.
+	/// Like SolveRun::Wait, this must not run on an executor thread, and the executor must still exist.
+	~BatchSolver();
+
+	BatchSolver(const BatchSolver& rhs) = delete;
+	BatchSolver& operator=(const BatchSolver& rhs) = delete;
+
+	/// Queues more levels. Indices continue from the previous submissions.
+	void Submit(const std::vector<std::shared_ptr<Game>>& games);
+
+	/// Blocks for the next level to finish, in completion order. Not to be called from an executor thread.
+	/// Returns false once every submitted level has been reported.
+	bool NextResult(BatchResult& result);
+
+	/// Stops all running levels between generations, queued levels are reported as cancelled.
+	void Cancel();
+
+private:
+	struct QueuedLevel
+	{
+		std::size_t Index;
+		std::shared_ptr<Game> LevelGame;
+		unsigned long long Genes;
+	};
+
+	struct PackedRun
+	{
+		std::size_t Index;
+		std::shared_ptr<SolveRun> Run;
+		unsigned long long Genes;
+	};
+
+	struct Pack
+	{
+		std::vector<PackedRun> Runs;
+		unsigned long long Genes;
+	};
+
+	SolveParameters ParametersFor(const Game& game) const;
+
+	/// All of the following expect m_Mutex to be held.
+	void StartLanes();
+	/// Moves pending small levels into the pack, up to limit genes but always at least one level.
+	void FillPack(Pack& pack, unsigned long long limit);
+	/// Even share of the pending genes over the given amount of lanes, at most PACK_GENES.
+	unsigned long long PackLimit(unsigned lanes) const;
+	void ReportPendingAsCancelled();
+
+	void RunPack(const std::shared_ptr<Pack>& pack);
+	void Report(std::size_t index, const std::shared_ptr<SolveRun>& run);
+	void ReleaseLane();
+
+	Executor& m_Executor;
+	BatchParameters m_Parameters;
+	unsigned m_MaxLanes;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_CondVar;
+	std::deque<QueuedLevel> m_Pending;
+	unsigned long long m_PendingGenes;
+	std::map<std::size_t, std::shared_ptr<SolveRun>> m_Running;
+	std::deque<BatchResult> m_Results;
+	std::size_t m_Submitted;
+	std::size_t m_Reported;
+	unsigned m_ActiveLanes;
+	bool m_Cancelled;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Numa.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed pool of threads running posted tasks in FIFO order.
+/// Threads are pinned round-robin over the NUMA nodes, like the Population workers.
+/// Work still queued when the executor is destroyed is dropped, so cancel and wait
+/// for everything running on it first. Runs and batches only make progress through queued
+/// tasks, so the executor has to outlive every SolveRun and BatchSolver using it.
+class Executor {
+public:
+	typedef std::function<void()> Task;
+
+	explicit Executor(unsigned threadsCount)
+		: m_Stopping(false)
+	{
+		if (threadsCount == 0)
+		{
+			threadsCount = 1;
+		}
+
+		const std::vector<Numa::CpuList>& nodes = Numa::Nodes();
+		for (unsigned t = 0; t < threadsCount; ++t)
+		{
+			const Numa::CpuList& cpus = nodes[t % nodes.size()];
+			unsigned cpu = cpus[(t / nodes.size()) % cpus.size()];
+
+			m_Threads.emplace_back(&Executor::ThreadRoutine, this, cpu);
+		}
+	}
+
+	Executor(const Executor &) = delete;
+	Executor & operator=(const Executor &) = delete;
+
+	~Executor()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+			m_Tasks.clear();
+		}
+		m_CondVar.notify_all();
+
+		for (std::thread& thread : m_Threads)
+		{
+			thread.join();
+		}
+	}
+
+	/// Queue a task, it will run on one of the pool threads
+	void Post(Task task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_Stopping)
+			{
+				return;
+			}
+			m_Tasks.push_back(std::move(task));
+		}
+		m_CondVar.notify_one();
+	}
+
+	unsigned ThreadsCount() const
+	{
+		return static_cast<unsigned>(m_Threads.size());
+	}
+
+	/// True when called from a task. Lets blocking calls catch being made from the pool they wait on.
+	bool IsPoolThread() const
+	{
+		const std::thread::id self = std::this_thread::get_id();
+		for (const std::thread& thread : m_Threads)
+		{
+			if (thread.get_id() == self)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	void ThreadRoutine(unsigned cpu)
+	{
+		Numa::PinCurrentThread(cpu);
+
+		while (true)
+		{
+			Task task;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_CondVar.wait(lock, [this]() { return m_Stopping || !m_Tasks.empty(); });
+
+				if (m_Stopping)
+				{
+					return;
+				}
+
+				task = std::move(m_Tasks.front());
+				m_Tasks.pop_front();
+			}
+
+			task();
+		}
+	}
+
+	bool                     m_Stopping; ///< set once by the destructor
+	std::deque<Task>         m_Tasks;    ///< tasks waiting for a thread
+	std::mutex               m_Mutex;    ///< lock protecting m_Tasks and m_Stopping
+	std::condition_variable  m_CondVar;  ///< signalled when a task is posted or on stop
+	std::vector<std::thread> m_Threads;
+};
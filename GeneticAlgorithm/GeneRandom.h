@@ -0,0 +1,119 @@
+#pragma once
+
+#include "GeneSequence.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/// xoshiro256++ running four independent streams side by side, producing four gene words per step.
+/// The lanes are stored as separate arrays, so the update loops map onto 256 bit vector registers.
+/// Cheap to construct, every chromosome gets its own generator and threads never share state.
+class GeneRandom
+{
+public:
+	typedef GeneSequence::Word Word;
+	static const unsigned LANES = 4;
+	/// Resolution of FillBiased probabilities.
+	static const unsigned PROBABILITY_ONE = 256;
+
+	explicit GeneRandom(std::uint64_t seed)
+	{
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			for (unsigned lane = 0; lane < LANES; ++lane)
+			{
+				m_State[i][lane] = SplitMix(seed);
+			}
+		}
+	}
+
+	/// Mixes two values into a seed, e.g. a run seed and a chromosome index.
+	static std::uint64_t Seed(std::uint64_t base, std::uint64_t index)
+	{
+		std::uint64_t state = base ^ (index * 0x9E3779B97F4A7C15ull);
+		return SplitMix(state);
+	}
+
+	/// Fills count words with bits that are set with probability probability / PROBABILITY_ONE.
+	/// Combines one uniform word per binary digit of the probability, from the lowest set digit up:
+	/// OR-ing in a uniform word maps p to (1 + p) / 2, AND-ing maps it to p / 2.
+	void FillBiased(Word* words, std::size_t count, unsigned probability)
+	{
+		if (probability == 0 || probability >= PROBABILITY_ONE)
+		{
+			const Word fill = probability == 0 ? 0 : ~Word(0);
+			for (std::size_t w = 0; w < count; ++w)
+			{
+				words[w] = fill;
+			}
+			return;
+		}
+
+		unsigned lowest = 0;
+		while (((probability >> lowest) & 1u) == 0)
+		{
+			++lowest;
+		}
+
+		Word block[LANES];
+		Word uniform[LANES];
+
+		for (std::size_t w = 0; w < count; w += LANES)
+		{
+			Next(block);
+
+			for (unsigned digit = lowest + 1; digit < 8; ++digit)
+			{
+				Next(uniform);
+
+				const bool set = (probability >> digit) & 1u;
+				for (unsigned lane = 0; lane < LANES; ++lane)
+				{
+					block[lane] = set ? (block[lane] | uniform[lane]) : (block[lane] & uniform[lane]);
+				}
+			}
+
+			for (unsigned lane = 0; lane < LANES && w + lane < count; ++lane)
+			{
+				words[w + lane] = block[lane];
+			}
+		}
+	}
+
+private:
+	static Word Rotl(Word value, unsigned shift)
+	{
+		return (value << shift) | (value >> (64 - shift));
+	}
+
+	static std::uint64_t SplitMix(std::uint64_t& state)
+	{
+		std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	void Next(Word (&out)[LANES])
+	{
+		Word (&s0)[LANES] = m_State[0];
+		Word (&s1)[LANES] = m_State[1];
+		Word (&s2)[LANES] = m_State[2];
+		Word (&s3)[LANES] = m_State[3];
+
+		for (unsigned lane = 0; lane < LANES; ++lane)
+		{
+			out[lane] = Rotl(s0[lane] + s3[lane], 23) + s0[lane];
+
+			const Word t = s1[lane] << 17;
+			s2[lane] ^= s0[lane];
+			s3[lane] ^= s1[lane];
+			s1[lane] ^= s2[lane];
+			s0[lane] ^= s3[lane];
+			s2[lane] ^= t;
+			s3[lane] = Rotl(s3[lane], 45);
+		}
+	}
+
+	Word m_State[4][LANES];
+};
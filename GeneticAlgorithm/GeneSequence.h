@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Genes packed 64 to a word.
+/// Unlike std::vector<bool> the words are accessible, so initialization and crossover work on whole words.
+/// Bits past Size() in the last word are always zero.
+class GeneSequence
+{
+public:
+	typedef std::uint64_t Word;
+	static const unsigned WORD_BITS = 64;
+
+	GeneSequence()
+		: m_Size(0)
+	{
+	}
+
+	std::size_t Size() const
+	{
+		return m_Size;
+	}
+
+	/// New genes are false.
+	void Resize(std::size_t size)
+	{
+		m_Words.resize((size + WORD_BITS - 1) / WORD_BITS, 0);
+		m_Size = size;
+		ClearTail();
+	}
+
+	bool operator[](std::size_t gene) const
+	{
+		return (m_Words[gene / WORD_BITS] >> (gene % WORD_BITS)) & 1u;
+	}
+
+	void Set(std::size_t gene, bool value)
+	{
+		const Word mask = Word(1) << (gene % WORD_BITS);
+		if (value)
+		{
+			m_Words[gene / WORD_BITS] |= mask;
+		}
+		else
+		{
+			m_Words[gene / WORD_BITS] &= ~mask;
+		}
+	}
+
+	void Flip(std::size_t gene)
+	{
+		m_Words[gene / WORD_BITS] ^= Word(1) << (gene % WORD_BITS);
+	}
+
+	std::size_t WordsCount() const
+	{
+		return m_Words.size();
+	}
+
+	Word* Words()
+	{
+		return m_Words.data();
+	}
+
+	const Word* Words() const
+	{
+		return m_Words.data();
+	}
+
+	/// Call after writing whole words to restore the zero tail.
+	void ClearTail()
+	{
+		if (m_Size % WORD_BITS != 0)
+		{
+			m_Words.back() &= (Word(1) << (m_Size % WORD_BITS)) - 1;
+		}
+	}
+
+	/// Makes this [0, point) of first followed by [point, Size()) of second.
+	void Splice(const GeneSequence& first, const GeneSequence& second, std::size_t point)
+	{
+		assert(first.Size() == second.Size());
+		assert(point <= first.Size());
+
+		Resize(first.Size());
+
+		const std::size_t pointWord = point / WORD_BITS;
+		for (std::size_t w = 0; w < pointWord; ++w)
+		{
+			m_Words[w] = first.m_Words[w];
+		}
+
+		if (pointWord < m_Words.size())
+		{
+			const Word firstMask = (Word(1) << (point % WORD_BITS)) - 1;
+			m_Words[pointWord] = (first.m_Words[pointWord] & firstMask) | (second.m_Words[pointWord] & ~firstMask);
+		}
+
+		for (std::size_t w = pointWord + 1; w < m_Words.size(); ++w)
+		{
+			m_Words[w] = second.m_Words[w];
+		}
+	}
+
+private:
+	std::vector<Word> m_Words;
+	std::size_t m_Size;
+};
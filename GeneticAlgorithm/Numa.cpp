@@ -0,0 +1,208 @@
+#include "Numa.h"
+
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+
+namespace
+{
+	Numa::CpuList AllCpus()
+	{
+		unsigned count = std::thread::hardware_concurrency();
+		if (count == 0)
+		{
+			count = 1;
+		}
+
+		Numa::CpuList cpus(count);
+		for (unsigned i = 0; i < count; ++i)
+		{
+			cpus[i] = i;
+		}
+
+		return cpus;
+	}
+
+#if defined(_WIN32)
+	std::vector<Numa::CpuList> DetectNodes()
+	{
+		std::vector<Numa::CpuList> nodes;
+
+		ULONG highestNode = 0;
+		if (!GetNumaHighestNodeNumber(&highestNode))
+		{
+			return nodes;
+		}
+
+		for (UCHAR node = 0; node <= highestNode; ++node)
+		{
+			ULONGLONG mask = 0;
+			if (!GetNumaNodeProcessorMask(node, &mask) || mask == 0)
+			{
+				continue;
+			}
+
+			Numa::CpuList cpus;
+			for (unsigned cpu = 0; cpu < 64; ++cpu)
+			{
+				if (mask & (1ull << cpu))
+				{
+					cpus.push_back(cpu);
+				}
+			}
+			nodes.push_back(cpus);
+		}
+
+		return nodes;
+	}
+#elif defined(__linux__)
+	/// Parses the sysfs list format, e.g. "0-7,16-23".
+	Numa::CpuList ParseCpuList(const std::string& text)
+	{
+		Numa::CpuList cpus;
+
+		std::stringstream stream(text);
+		std::string range;
+		while (std::getline(stream, range, ','))
+		{
+			if (range.empty() || range[0] == '\n')
+			{
+				continue;
+			}
+
+			unsigned first = 0;
+			unsigned last = 0;
+			if (std::sscanf(range.c_str(), "%u-%u", &first, &last) != 2)
+			{
+				last = first;
+			}
+
+			for (unsigned cpu = first; cpu <= last; ++cpu)
+			{
+				cpus.push_back(cpu);
+			}
+		}
+
+		return cpus;
+	}
+
+	/// Processors the process may run on, e.g. restricted by a cpuset or taskset.
+	/// Empty if the affinity could not be read.
+	Numa::CpuList AllowedCpus()
+	{
+		Numa::CpuList cpus;
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) != 0)
+		{
+			return cpus;
+		}
+
+		for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+		{
+			if (CPU_ISSET(cpu, &set))
+			{
+				cpus.push_back(cpu);
+			}
+		}
+
+		return cpus;
+	}
+
+	/// Nodes without any allowed processor are left out, pinning to them would fail.
+	std::vector<Numa::CpuList> DetectNodes()
+	{
+		std::vector<Numa::CpuList> nodes;
+		const Numa::CpuList allowed = AllowedCpus();
+
+		/// Node numbers are not guaranteed to be contiguous, but they are small.
+		for (unsigned node = 0; node < 1024; ++node)
+		{
+			std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+			if (!file)
+			{
+				continue;
+			}
+
+			std::string text;
+			std::getline(file, text);
+
+			Numa::CpuList cpus;
+			for (unsigned cpu : ParseCpuList(text))
+			{
+				if (allowed.empty() || std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+				{
+					cpus.push_back(cpu);
+				}
+			}
+
+			if (!cpus.empty())
+			{
+				nodes.push_back(cpus);
+			}
+		}
+
+		/// Without sysfs node information the allowed processors still make up the single node.
+		if (nodes.empty() && !allowed.empty())
+		{
+			nodes.push_back(allowed);
+		}
+
+		return nodes;
+	}
+#else
+	std::vector<Numa::CpuList> DetectNodes()
+	{
+		return std::vector<Numa::CpuList>();
+	}
+#endif
+};
+
+const std::vector<Numa::CpuList>& Numa::Nodes()
+{
+	static const std::vector<CpuList> nodes = []() {
+		std::vector<CpuList> detected = DetectNodes();
+		if (detected.empty())
+		{
+			detected.push_back(AllCpus());
+		}
+		return detected;
+	}();
+
+	return nodes;
+}
+
+bool Numa::PinCurrentThread(unsigned cpu)
+{
+#if defined(_WIN32)
+	if (cpu >= 64)
+	{
+		return false;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1ull << cpu)) != 0;
+#elif defined(__linux__)
+	if (cpu >= CPU_SETSIZE)
+	{
+		return false;
+	}
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	(void)cpu;
+	return false;
+#endif
+}
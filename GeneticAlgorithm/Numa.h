@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+/// Minimal view of the machine topology used to place worker threads.
+/// On platforms without NUMA information everything is reported as a single node.
+namespace Numa
+{
+	typedef std::vector<unsigned> CpuList;
+
+	/// Logical processors of every NUMA node, indexed by node number.
+	/// Contains at least one node with at least one processor.
+	const std::vector<CpuList>& Nodes();
+
+	/// Binds the calling thread to a single logical processor.
+	/// Memory the thread touches first afterwards is placed on the processor's node.
+	bool PinCurrentThread(unsigned cpu);
+};
@@ -0,0 +1,177 @@
+#include "PerfCounters.h"
+
+#if defined(GENETIC_PERF_COUNTERS)
+
+#include <iomanip>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdint>
+#endif
+
+namespace
+{
+	const char* PHASE_NAMES[] = { "selection", "replicate", "crossover", "mutation", "fitness", "sort" };
+
+	static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == static_cast<unsigned>(PerfPhase::Count),
+		"Every phase needs a name");
+
+	enum Counter
+	{
+		Cycles,
+		Instructions,
+		BranchMisses,
+		LlcMisses,
+		CountersCount
+	};
+
+#if defined(__linux__)
+	int OpenCounter(std::uint64_t config, int groupFd)
+	{
+		perf_event_attr attr = {};
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		/// The enabled and running times tell how long the group was multiplexed out.
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		/// pid 0 and cpu -1 count the calling thread on whichever CPU it runs.
+		return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+	}
+#endif
+};
+
+PerfCounters::PerfCounters()
+	: m_Leader(-1)
+	, m_Opened(0)
+	, m_Start()
+{
+	for (unsigned c = 0; c < CountersCount; ++c)
+	{
+		m_Slots[c] = -1;
+		m_Descriptors[c] = -1;
+	}
+
+#if defined(__linux__)
+	/// PERF_COUNT_HW_CACHE_MISSES is mapped to last level cache misses by the kernel.
+	const std::uint64_t configs[CountersCount] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_BRANCH_MISSES,
+		PERF_COUNT_HW_CACHE_MISSES
+	};
+
+	for (unsigned c = 0; c < CountersCount; ++c)
+	{
+		int fd = OpenCounter(configs[c], m_Leader);
+		if (fd == -1)
+		{
+			/// Without a leader there is nothing to group the rest under.
+			if (c == Cycles)
+			{
+				return;
+			}
+			continue;
+		}
+
+		if (m_Leader == -1)
+		{
+			m_Leader = fd;
+		}
+
+		m_Descriptors[c] = fd;
+		m_Slots[c] = static_cast<int>(m_Opened++);
+	}
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+	for (unsigned c = 0; c < CountersCount; ++c)
+	{
+		if (m_Descriptors[c] != -1)
+		{
+			close(m_Descriptors[c]);
+		}
+	}
+#endif
+}
+
+void PerfCounters::Start()
+{
+	m_Start = Read();
+}
+
+void PerfCounters::Stop(PerfSample& sample)
+{
+	const Reading end = Read();
+
+	/// When more counters are in use than the PMU has, the group only runs part of the time.
+	/// Scales the deltas up to the whole interval, which is what perf stat does too. The raw values
+	/// are cumulative and exact, so only the deltas are scaled and they never go negative.
+	const unsigned long long enabled = end.Enabled - m_Start.Enabled;
+	const unsigned long long running = end.Running - m_Start.Running;
+	const double scale = running == 0 ? 0.0 : static_cast<double>(enabled) / running;
+
+	auto delta = [this, &end, scale](Counter counter) -> unsigned long long {
+		return static_cast<unsigned long long>((end.Values[counter] - m_Start.Values[counter]) * scale);
+	};
+
+	sample.Cycles = delta(Cycles);
+	sample.Instructions = delta(Instructions);
+	sample.BranchMisses = delta(BranchMisses);
+	sample.LlcMisses = delta(LlcMisses);
+}
+
+PerfCounters::Reading PerfCounters::Read() const
+{
+	Reading reading = {};
+
+#if defined(__linux__)
+	if (!Opened())
+	{
+		return reading;
+	}
+
+	/// Read format layout: number of counters, time enabled, time running, then the counter values.
+	std::uint64_t values[3 + CountersCount] = {};
+	if (read(m_Leader, values, sizeof(values)) <= 0)
+	{
+		return reading;
+	}
+
+	reading.Enabled = values[1];
+	reading.Running = values[2];
+	for (unsigned c = 0; c < CountersCount; ++c)
+	{
+		reading.Values[c] = m_Slots[c] == -1 ? 0 : values[3 + m_Slots[c]];
+	}
+#endif
+
+	return reading;
+}
+
+void PrintPerfPhases(std::ostream& out, const PerfPhases& phases)
+{
+	for (unsigned p = 0; p < static_cast<unsigned>(PerfPhase::Count); ++p)
+	{
+		const PerfSample& sample = phases[p];
+
+		out << "  " << std::setw(9) << std::left << PHASE_NAMES[p] << std::right
+			<< " cycles: " << sample.Cycles
+			<< " instructions: " << sample.Instructions
+			<< " ipc: " << std::fixed << std::setprecision(2)
+			<< (sample.Cycles ? static_cast<double>(sample.Instructions) / sample.Cycles : 0.0)
+			<< std::defaultfloat
+			<< " branch-misses: " << sample.BranchMisses
+			<< " llc-misses: " << sample.LlcMisses << "\n";
+	}
+}
+
+#endif
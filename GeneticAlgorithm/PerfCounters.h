@@ -0,0 +1,145 @@
+#pragma once
+
+#include <ostream>
+
+/// Optional hardware performance counters around the GA phases.
+/// Define GENETIC_PERF_COUNTERS to build them in; otherwise every call below is an empty inline function.
+/// Counters are read through perf_event_open and are only available on Linux.
+
+enum class PerfPhase
+{
+	Selection,
+	/// Per node elite copies, including the wait for the node leader to make them.
+	Replication,
+	Crossover,
+	Mutation,
+	Fitness,
+	Sort,
+	Count
+};
+
+struct PerfSample
+{
+	unsigned long long Cycles;
+	unsigned long long Instructions;
+	unsigned long long BranchMisses;
+	unsigned long long LlcMisses;
+
+	PerfSample& operator+=(const PerfSample& rhs)
+	{
+		Cycles += rhs.Cycles;
+		Instructions += rhs.Instructions;
+		BranchMisses += rhs.BranchMisses;
+		LlcMisses += rhs.LlcMisses;
+		return *this;
+	}
+};
+
+typedef PerfSample PerfPhases[static_cast<unsigned>(PerfPhase::Count)];
+
+inline PerfSample& PhaseSample(PerfPhases& phases, PerfPhase phase)
+{
+	return phases[static_cast<unsigned>(phase)];
+}
+
+#if defined(GENETIC_PERF_COUNTERS)
+
+/// Counters of the thread that created the object. Not to be shared between threads.
+class PerfCounters
+{
+public:
+	PerfCounters();
+	~PerfCounters();
+
+	PerfCounters(const PerfCounters& rhs) = delete;
+	PerfCounters& operator=(const PerfCounters& rhs) = delete;
+
+	/// False when the kernel refused to open the counters, e.g. because of perf_event_paranoid.
+	bool Opened() const
+	{
+		return m_Leader != -1;
+	}
+
+	void Start();
+	void Stop(PerfSample& sample);
+
+	static constexpr bool Enabled()
+	{
+		return true;
+	}
+
+private:
+	/// Unscaled counter values, in the order of PerfSample, with the times the group was enabled and running.
+	struct Reading
+	{
+		unsigned long long Values[4];
+		unsigned long long Enabled;
+		unsigned long long Running;
+	};
+
+	Reading Read() const;
+
+	int m_Leader;
+	/// Index of every counter in the group read, -1 if it could not be opened.
+	int m_Slots[4];
+	int m_Descriptors[4];
+	unsigned m_Opened;
+	Reading m_Start;
+};
+
+/// Prints one line per phase with the counters summed over all threads.
+void PrintPerfPhases(std::ostream& out, const PerfPhases& phases);
+
+#else
+
+class PerfCounters
+{
+public:
+	bool Opened() const
+	{
+		return false;
+	}
+
+	void Start()
+	{
+	}
+
+	void Stop(PerfSample&)
+	{
+	}
+
+	static constexpr bool Enabled()
+	{
+		return false;
+	}
+};
+
+inline void PrintPerfPhases(std::ostream&, const PerfPhases&)
+{
+}
+
+#endif
+
+/// Measures the enclosing scope into the given phase sample.
+class PerfScope
+{
+public:
+	PerfScope(PerfCounters& counters, PerfSample& sample)
+		: m_Counters(counters)
+		, m_Sample(sample)
+	{
+		m_Counters.Start();
+	}
+
+	~PerfScope()
+	{
+		m_Counters.Stop(m_Sample);
+	}
+
+	PerfScope(const PerfScope& rhs) = delete;
+	PerfScope& operator=(const PerfScope& rhs) = delete;
+
+private:
+	PerfCounters& m_Counters;
+	PerfSample& m_Sample;
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Population.h"
+#include "GeneRandom.h"
+#include "Numa.h"
 
 #include <random>
 #include <algorithm>
@@ -14,6 +16,11 @@ namespace
 	static const unsigned MIN_MUTATION_SEQUENCE = 2;
 	static const unsigned MAX_MUTATION_SEQUENCE = 5;
 
+	/// Chance out of GeneRandom::PROBABILITY_ONE to flip a gene of a planner seeded chromosome.
+	static const unsigned PLANNER_NOISE = 2;
+	/// Frames the planner extrapolates the current velocity, damps its oscillation around the target.
+	static const float PLANNER_LOOKAHEAD = 4.f;
+
 	struct Randomizator
 	{
 		mutable std::mt19937 generator;
@@ -55,6 +62,15 @@ namespace
 	};
 };
 
+Population::Population()
+	: m_ChromosomeSize(0)
+	, m_Fittest(0)
+	, m_SelectionRatio(0.f)
+{
+	std::random_device device;
+	m_Seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+}
+
 Population::Chromosome Population::FindSolution(SizeType populationSize,
 	SizeType chromosomeSize,
 	float selectionRatio,
@@ -65,6 +81,7 @@ Population::Chromosome Population::FindSolution(SizeType populationSize,
 	m_Game = game;
 	m_Fittest = 0;
 	m_SelectionRatio = selectionRatio;
+	PreparePlan();
 
 	unsigned allThreads = std::thread::hardware_concurrency();
 	if (allThreads == 0)
@@ -74,21 +91,76 @@ Population::Chromosome Population::FindSolution(SizeType populationSize,
 	else
 	{
 		/// Number of cores
-		MultiThreadRoutine(allThreads / 2);
+		MultiThreadRoutine(std::max(allThreads / 2, 1u));
 	}
 
 	return m_Chromosomes[m_Fittest];
 }
 
+void Population::Prepare(SizeType populationSize,
+	SizeType chromosomeSize,
+	float selectionRatio,
+	const std::shared_ptr<Game>& game)
+{
+	m_Chromosomes.resize(populationSize);
+	m_NewChromosomes.resize(populationSize);
+	m_ChromosomeSize = chromosomeSize;
+	m_Game = game;
+	m_Fittest = 0;
+	m_SelectionRatio = selectionRatio;
+	PreparePlan();
+}
+
+void Population::InitializeRange(SizeType start, SizeType end)
+{
+	while (start < end)
+	{
+		RandomizeChromosome(start);
+		m_Chromosomes[start].Fitness = CalculateFitness(m_Chromosomes[start]);
+		++start;
+	}
+}
+
+void Population::FinishInitialization()
+{
+	FindFittest();
+}
+
+void Population::BeginGeneration()
+{
+	MultiThreadSelection(m_NewChromosomes);
+}
+
+void Population::EvolveRange(SizeType start, SizeType end)
+{
+	ThreadCrossover(m_Chromosomes, m_NewChromosomes, start, end);
+	ThreadMutation(m_NewChromosomes, start, end);
+	ThreadCalculateFitness(m_NewChromosomes, start, end);
+}
+
+void Population::EndGeneration()
+{
+	m_Chromosomes.swap(m_NewChromosomes);
+	FindFittest();
+}
+
+Population::SizeType Population::ElitesCount() const
+{
+	return static_cast<SizeType>(std::floor(m_Chromosomes.size() * m_SelectionRatio));
+}
+
 void Population::SingleThreadRoutine()
 {
 	for (SizeType i = 0; i < m_Chromosomes.size(); ++i)
 	{
-		RandomizeChromosome(m_Chromosomes[i]);
+		RandomizeChromosome(i);
 	}
 
 	CalculateFitness();
 
+	PerfCounters counters;
+	PerfPhases phases = {};
+
 	long long generation = 1;
 	while (!FoundSolution())
 	{
@@ -96,18 +168,31 @@ void Population::SingleThreadRoutine()
 
 		std::vector<Chromosome> newChromosomes;
 
-		SelectionSingleThread(newChromosomes);
-		CrossoverSingleThread(newChromosomes);
-		MutationSingleThread(newChromosomes);
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Selection));
+			SelectionSingleThread(newChromosomes);
+		}
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Crossover));
+			CrossoverSingleThread(newChromosomes);
+		}
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Mutation));
+			MutationSingleThread(newChromosomes);
+		}
 
 		m_Chromosomes.swap(newChromosomes);
 
-		CalculateFitness();
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Fitness));
+			CalculateFitness();
+		}
 
 		auto end = std::chrono::high_resolution_clock::now();
 		std::cout << "Generation time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms"
 			<< " Fittest: " << GetFittest().Fitness
 			<< " generation: " << ++generation << "\n";
+		PrintPerfPhases(std::cout, phases);
 	}
 }
 
@@ -123,16 +208,136 @@ void Population::FindFittest()
 	}
 }
 
-void Population::ThreadInitializeChromosomes(SizeType start, SizeType end)
+void Population::PlaceWorkers(unsigned threadsCount)
 {
-	while (start < end)
+	const std::vector<Numa::CpuList>& nodes = Numa::Nodes();
+	const unsigned nodesCount = static_cast<unsigned>(nodes.size());
+
+	m_Workers.assign(threadsCount, Worker());
+
+	std::vector<unsigned> placedOnNode(nodesCount, 0);
+	for (unsigned t = 0; t < threadsCount; ++t)
 	{
-		RandomizeChromosome(m_Chromosomes[start]);
-		m_Chromosomes[start].Fitness = CalculateFitness(m_Chromosomes[start]);
-		++start;
+		/// Consecutive workers share a node, so neighbouring chunks of the population stay on the same node.
+		unsigned node = static_cast<unsigned>(static_cast<unsigned long long>(t) * nodesCount / threadsCount);
+		const Numa::CpuList& cpus = nodes[node];
+
+		m_Workers[t].Node = node;
+		m_Workers[t].Cpu = cpus[placedOnNode[node] % cpus.size()];
+		m_Workers[t].NodeLeader = placedOnNode[node] == 0;
+		m_Workers[t].Evaluations = 0;
+		m_Workers[t].BusyNanoseconds = 0;
+		std::fill(std::begin(m_Workers[t].Perf), std::end(m_Workers[t].Perf), PerfSample());
+
+		++placedOnNode[node];
+	}
+
+	m_NodeElites.clear();
+	m_NodeElites.resize(nodesCount);
+
+	m_NodeElitesReady.clear();
+	for (unsigned n = 0; n < nodesCount; ++n)
+	{
+		m_NodeElitesReady.push_back(std::make_unique<WaitGroup>(1));
+	}
+}
+
+void Population::PinWorker(unsigned worker)
+{
+	/// Not being able to pin only costs locality, so failures are ignored.
+	Numa::PinCurrentThread(m_Workers[worker].Cpu);
+}
+
+void Population::ReplicateElites(unsigned worker)
+{
+	/// With a single node every worker reads the elites straight from m_Chromosomes.
+	if (m_NodeElites.size() <= 1)
+	{
+		return;
+	}
+
+	const Worker& self = m_Workers[worker];
+	WaitGroup& ready = *m_NodeElitesReady[self.Node];
+
+	if (self.NodeLeader)
+	{
+		/// Crossover picks the first parent from [0, elites], see ThreadCrossover.
+		SizeType elites = static_cast<SizeType>(std::floor(m_Chromosomes.size() * m_SelectionRatio));
+		SizeType replicated = std::min(elites + 1, static_cast<SizeType>(m_Chromosomes.size()));
+
+		/// Assigning over the previous copy reuses the gene storage allocated on this node.
+		m_NodeElites[self.Node].assign(m_Chromosomes.begin(), m_Chromosomes.begin() + replicated);
+		ready.done();
+	}
+	else
+	{
+		ready.wait();
+	}
+}
+
+const std::vector<Population::Chromosome>& Population::EliteSource(unsigned worker) const
+{
+	if (m_NodeElites.size() <= 1)
+	{
+		return m_Chromosomes;
+	}
+
+	return m_NodeElites[m_Workers[worker].Node];
+}
+
+void Population::ReportNodeThroughput()
+{
+	for (unsigned node = 0; node < m_NodeElites.size(); ++node)
+	{
+		unsigned long long evaluations = 0;
+		long long busyNanoseconds = 0;
+
+		for (const Worker& worker : m_Workers)
+		{
+			if (worker.Node == node)
+			{
+				evaluations += worker.Evaluations;
+				busyNanoseconds = std::max(busyNanoseconds, worker.BusyNanoseconds);
+			}
+		}
+
+		if (busyNanoseconds > 0)
+		{
+			std::cout << " node" << node << ": "
+				<< static_cast<unsigned long long>(evaluations * 1e9 / busyNanoseconds) << " chromosomes/s";
+		}
 	}
 }
 
+void Population::ReportPerf(const PerfSample& selection)
+{
+	if (!PerfCounters::Enabled())
+	{
+		return;
+	}
+
+	PerfPhases phases = {};
+	PhaseSample(phases, PerfPhase::Selection) = selection;
+
+	for (const Worker& worker : m_Workers)
+	{
+		for (unsigned p = 0; p < static_cast<unsigned>(PerfPhase::Count); ++p)
+		{
+			phases[p] += worker.Perf[p];
+		}
+	}
+
+	PrintPerfPhases(std::cout, phases);
+}
+
+void Population::ThreadInitializeChromosomes(unsigned worker, SizeType start, SizeType end)
+{
+	/// Pin before touching the genes so they are allocated on the worker's node.
+	PinWorker(worker);
+
+	InitializeRange(start, end);
+}
+
 void Population::MultiThreadInitializeChromosomes(unsigned threadsCount)
 {
 	std::vector<std::thread> initializerThreads(threadsCount);
@@ -143,12 +348,13 @@ void Population::MultiThreadInitializeChromosomes(unsigned threadsCount)
 	for (unsigned t = 0; t < threadsCount - 1; ++t)
 	{
 		SizeType chunkEnd = chunkStart + chunk;
-		initializerThreads[t] = std::thread(&Population::ThreadInitializeChromosomes, this, chunkStart, chunkEnd);
+		initializerThreads[t] = std::thread(&Population::ThreadInitializeChromosomes, this, t, chunkStart, chunkEnd);
 		chunkStart = chunkEnd;
 	}
 
 	initializerThreads[threadsCount - 1] = std::thread(&Population::ThreadInitializeChromosomes,
 		this,
+		threadsCount - 1,
 		chunkStart,
 		static_cast<SizeType>(m_Chromosomes.size()));
 
@@ -162,6 +368,8 @@ void Population::MultiThreadInitializeChromosomes(unsigned threadsCount)
 
 void Population::MultiThreadRoutine(unsigned threadsCount)
 {
+	PlaceWorkers(threadsCount);
+
 	MultiThreadInitializeChromosomes(threadsCount);
 
 	if (FoundSolution())
@@ -176,6 +384,7 @@ void Population::MultiThreadRoutine(unsigned threadsCount)
 
 	std::vector<std::thread> threads(threadsCount);
 	m_ThreadsWorkingWaitGroup.reset(threadsCount);
+	m_ThreadsReadyForWorkWaitGroups[0].reset(1);
 
 	SizeType selected = static_cast<SizeType>(std::floor(m_Chromosomes.size() * m_SelectionRatio));
 	/// Skip elites because they will not be changed.
@@ -187,6 +396,7 @@ void Population::MultiThreadRoutine(unsigned threadsCount)
 		SizeType endChunk = startChunk + chromosomesPerThread;
 		threads[i] = std::thread(&Population::ThreadRoutine,
 			this,
+			i,
 			std::ref(newChromosomes),
 			startChunk,
 			endChunk);
@@ -197,12 +407,21 @@ void Population::MultiThreadRoutine(unsigned threadsCount)
 	/// Last chunk might have a different size.
 	threads[threadsCount - 1] = std::thread(&Population::ThreadRoutine,
 		this,
+		threadsCount - 1,
 		std::ref(newChromosomes),
 		startChunk,
 		static_cast<SizeType>(m_Chromosomes.size()));
 
+	PerfCounters counters;
+	PerfSample selection = {};
+	if (PerfCounters::Enabled() && !counters.Opened())
+	{
+		std::cerr << "Performance counters are not available, phases will report zeros\n";
+	}
+
 	auto start = std::chrono::high_resolution_clock::now();
 	long long generation = 1;
+	unsigned parity = 0;
 	while (true)
 	{
 		m_ThreadsWorkingWaitGroup.wait();
@@ -219,16 +438,30 @@ void Population::MultiThreadRoutine(unsigned threadsCount)
 		auto end = std::chrono::high_resolution_clock::now();
 		std::cout << "Generation time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms"
 			<< " Fittest: " << GetFittest().Fitness
-			<< " generation: " << ++generation << "\n";
+			<< " generation: " << ++generation;
+		ReportNodeThroughput();
+		std::cout << "\n";
+		ReportPerf(selection);
 
 		start = std::chrono::high_resolution_clock::now();
-		MultiThreadSelection(newChromosomes);
+		{
+			PerfScope scope(counters, selection);
+			MultiThreadSelection(newChromosomes);
+		}
 
+		for (auto& ready : m_NodeElitesReady)
+		{
+			ready->reset(1);
+		}
+
+		/// Arm the other group before releasing this one, so a fast worker cannot run through it.
+		m_ThreadsReadyForWorkWaitGroups[parity ^ 1].reset(1);
 		m_ThreadsWorkingWaitGroup.reset(threadsCount);
-		m_ThreadsReadyForWorkWaitGroup.done();
+		m_ThreadsReadyForWorkWaitGroups[parity].done();
+		parity ^= 1;
 	}
 
-	m_ThreadsReadyForWorkWaitGroup.done();
+	m_ThreadsReadyForWorkWaitGroups[parity].done();
 
 	for (unsigned i = 0; i < threadsCount; ++i)
 	{
@@ -236,22 +469,50 @@ void Population::MultiThreadRoutine(unsigned threadsCount)
 	}
 }
 
-void Population::ThreadRoutine(std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end)
+void Population::ThreadRoutine(unsigned worker, std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end)
 {
+	/// Children are allocated by DoCrossover on this thread, so the slice is first touched on the worker's node.
+	PinWorker(worker);
+
+	/// Opened after pinning, the counters follow this thread only.
+	PerfCounters counters;
+	PerfPhases& phases = m_Workers[worker].Perf;
+
+	unsigned parity = 0;
 	while (!FoundSolution())
 	{
-		ThreadCrossover(newChromosomes, start, end);
-		ThreadMutation(newChromosomes, start, end);
-		ThreadCalculateFitness(newChromosomes, start, end);
+		auto busyStart = std::chrono::high_resolution_clock::now();
 
-		std::sort(newChromosomes.begin() + start, newChromosomes.begin() + end, [](const Chromosome& lhs, const Chromosome& rhs) {
-			return lhs.Fitness > rhs.Fitness;
-		});
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Replication));
+			ReplicateElites(worker);
+		}
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Crossover));
+			ThreadCrossover(EliteSource(worker), newChromosomes, start, end);
+		}
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Mutation));
+			ThreadMutation(newChromosomes, start, end);
+		}
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Fitness));
+			ThreadCalculateFitness(newChromosomes, start, end);
+		}
+		{
+			PerfScope scope(counters, PhaseSample(phases, PerfPhase::Sort));
+			std::sort(newChromosomes.begin() + start, newChromosomes.begin() + end, [](const Chromosome& lhs, const Chromosome& rhs) {
+				return lhs.Fitness > rhs.Fitness;
+			});
+		}
+
+		m_Workers[worker].Evaluations = end - start;
+		m_Workers[worker].BusyNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::high_resolution_clock::now() - busyStart).count();
 
 		m_ThreadsWorkingWaitGroup.done();
-		m_ThreadsWorkingWaitGroup.wait();
-		m_ThreadsReadyForWorkWaitGroup.reset(1);
-		m_ThreadsReadyForWorkWaitGroup.wait();
+		m_ThreadsReadyForWorkWaitGroups[parity].wait();
+		parity ^= 1;
 	}
 }
 
@@ -269,16 +530,41 @@ void Population::MultiThreadSelection(std::vector<Chromosome>& newChromosomes)
 	}
 }
 
-void Population::RandomizeChromosome(Chromosome& chromosome)
+void Population::RandomizeChromosome(SizeType index)
 {
-	static Coin coin;
+	Chromosome& chromosome = m_Chromosomes[index];
+	chromosome.Genes.Resize(m_ChromosomeSize);
 
-	chromosome.Genes.resize(m_ChromosomeSize);
+	GeneRandom random(GeneRandom::Seed(m_Seed, index));
 
-	for (SizeType i = 0; i < m_ChromosomeSize; ++i)
+	GeneSequence::Word* words = chromosome.Genes.Words();
+	const std::size_t wordsCount = chromosome.Genes.WordsCount();
+
+	const SizeType planned = static_cast<SizeType>(std::floor(m_Chromosomes.size() * m_Seeding.PlannerRatio));
+	if (index < planned)
 	{
-		chromosome.Genes[i] = (coin.Flip() == Coin::Face::Head ? true : false);
+		std::copy(m_Plan.Words(), m_Plan.Words() + wordsCount, words);
+
+		/// Sparse noise on all but the first, so the planned chromosomes are not all the same.
+		GeneSequence::Word noise[GeneRandom::LANES];
+		for (std::size_t w = 0; index > 0 && w < wordsCount; w += GeneRandom::LANES)
+		{
+			random.FillBiased(noise, GeneRandom::LANES, PLANNER_NOISE);
+			for (unsigned lane = 0; lane < GeneRandom::LANES && w + lane < wordsCount; ++lane)
+			{
+				words[w + lane] ^= noise[lane];
+			}
+		}
+	}
+	else
+	{
+		/// Clamped first, a negative probability would wrap around to all jumps. NaN counts as 0.
+		const float jumpProbability = m_Seeding.JumpProbability > 0.f ? std::min(m_Seeding.JumpProbability, 1.f) : 0.f;
+		const unsigned probability = static_cast<unsigned>(std::lround(jumpProbability * GeneRandom::PROBABILITY_ONE));
+		random.FillBiased(words, wordsCount, probability);
 	}
+
+	chromosome.Genes.ClearTail();
 }
 
 void Population::CalculateFitness()
@@ -328,8 +614,70 @@ namespace
 
 		return true;
 	}
+
+	/// Pylons ordered by their center, the order in which the planner steers to them.
+	std::vector<const LevelDescription::Pylon*> plannerPylons(const LevelDescription& level)
+	{
+		std::vector<const LevelDescription::Pylon*> pylons;
+		for (const LevelDescription::Pylon& pylon : level.pylons)
+		{
+			pylons.push_back(&pylon);
+		}
+
+		std::stable_sort(pylons.begin(), pylons.end(), [](const LevelDescription::Pylon* lhs, const LevelDescription::Pylon* rhs) {
+			return lhs->center.x < rhs->center.x;
+		});
+
+		return pylons;
+	}
 };
 
+/// Greedy controller using the same physics as CalculateFitness:
+/// jump whenever the bird is heading below the gap of the next pylon, or the middle of the level past the last one.
+/// The plan only depends on the level, so it is computed once and copied into every planned chromosome.
+void Population::PreparePlan()
+{
+	const SizeType planned = static_cast<SizeType>(std::floor(m_Chromosomes.size() * m_Seeding.PlannerRatio));
+	if (planned == 0)
+	{
+		m_Plan.Resize(0);
+		return;
+	}
+
+	const LevelDescription& level = m_Game->Level;
+	const std::vector<const LevelDescription::Pylon*> pylons = plannerPylons(level);
+
+	Point2d bird{ 0, level.height / 2 };
+	Point2d velocity{ m_Game->HorizontalVelocity, 0 };
+
+	m_Plan.Resize(m_ChromosomeSize);
+
+	/// The bird only moves right, so a pylon it has passed stays behind. The next pylon is the
+	/// first one in center order that is not entirely behind the bird.
+	std::size_t next = 0;
+	for (std::size_t gene = 0; gene < m_Plan.Size(); ++gene)
+	{
+		while (next < pylons.size() && pylons[next]->center.x + pylons[next]->width / 2 < bird.x)
+		{
+			++next;
+		}
+
+		const float target = next < pylons.size() ? pylons[next]->center.y : level.height / 2;
+
+		velocity.y += m_Game->VerticalAcceleration;
+
+		/// y grows downwards, falling increases it.
+		const bool jump = bird.y + velocity.y * PLANNER_LOOKAHEAD > target;
+		if (jump)
+		{
+			velocity.y -= m_Game->JumpAcceleartion;
+		}
+
+		bird += velocity;
+		m_Plan.Set(gene, jump);
+	}
+}
+
 /// Returns the number of frames that the bird was alive.
 Population::Fitness Population::CalculateFitness(const Chromosome& chromosome)
 {
@@ -338,8 +686,11 @@ Population::Fitness Population::CalculateFitness(const Chromosome& chromosome)
 	Point2d bird{ 0, m_Game->Level.height / 2 };
 	Point2d velocity{ m_Game->HorizontalVelocity, 0 };
 
-	for (bool jumpGene : chromosome.Genes)
+	const GeneSequence& genes = chromosome.Genes;
+	for (std::size_t gene = 0; gene < genes.Size(); ++gene)
 	{
+		const bool jumpGene = genes[gene];
+
 		/// Always falling, even if jumping.
 		velocity.y += m_Game->VerticalAcceleration;
 		if (jumpGene)
@@ -378,22 +729,12 @@ namespace
 {
 	Population::Chromosome DoCrossover(const Population::Chromosome& first, const Population::Chromosome& second)
 	{
-		assert(first.Genes.size() == second.Genes.size());
+		assert(first.Genes.Size() == second.Genes.Size());
 
-		Population::SizeType chromosomeSize = static_cast<Population::SizeType>(first.Genes.size());
 		Population::SizeType crossoverPoint = first.Fitness;
 
 		Population::Chromosome child;
-		child.Genes.resize(chromosomeSize);
-
-		for (Population::SizeType i = 0; i < crossoverPoint; ++i)
-		{
-			child.Genes[i] = first.Genes[i];
-		}
-		for (Population::SizeType i = crossoverPoint; i < chromosomeSize; ++i)
-		{
-			child.Genes[i] = second.Genes[i];
-		}
+		child.Genes.Splice(first.Genes, second.Genes, crossoverPoint);
 
 		return child;
 	}
@@ -425,35 +766,35 @@ void Population::CrossoverSingleThread(std::vector<Chromosome>& newChromosomes)
 
 void Population::RandomMutation(Chromosome& mutated)
 {
-	Randomizator geneRandomizator(0, static_cast<unsigned>(mutated.Genes.size() - 1));
+	Randomizator geneRandomizator(0, static_cast<unsigned>(mutated.Genes.Size() - 1));
 
 	SizeType mutatedGene = geneRandomizator.Get();
-	mutated.Genes[mutatedGene] = !mutated.Genes[mutatedGene];
+	mutated.Genes.Flip(mutatedGene);
 
 	mutatedGene = geneRandomizator.Get();
-	mutated.Genes[mutatedGene] = !mutated.Genes[mutatedGene];
+	mutated.Genes.Flip(mutatedGene);
 
 	mutatedGene = geneRandomizator.Get();
-	mutated.Genes[mutatedGene] = !mutated.Genes[mutatedGene];
+	mutated.Genes.Flip(mutatedGene);
 
 	mutatedGene = geneRandomizator.Get();
-	mutated.Genes[mutatedGene] = !mutated.Genes[mutatedGene];
+	mutated.Genes.Flip(mutatedGene);
 
 	mutatedGene = geneRandomizator.Get();
-	mutated.Genes[mutatedGene] = !mutated.Genes[mutatedGene];
+	mutated.Genes.Flip(mutatedGene);
 }
 
 void Population::SequentialMutation(Chromosome& mutated)
 {
-	Randomizator geneRandomizator(0, static_cast<unsigned>(mutated.Genes.size() - 1));
+	Randomizator geneRandomizator(0, static_cast<unsigned>(mutated.Genes.Size() - 1));
 	Randomizator sequenceRandomizator(MIN_MUTATION_SEQUENCE, MAX_MUTATION_SEQUENCE);
 
 	SizeType sequenceCurrent = geneRandomizator.Get();
 	SizeType sequenceEnd = sequenceCurrent + sequenceRandomizator.Get();
 
-	while (sequenceCurrent != sequenceEnd && sequenceCurrent < mutated.Genes.size())
+	while (sequenceCurrent != sequenceEnd && sequenceCurrent < mutated.Genes.Size())
 	{
-		mutated.Genes[sequenceCurrent] = !mutated.Genes[sequenceCurrent];
+		mutated.Genes.Flip(sequenceCurrent);
 		++sequenceCurrent;
 	}
 }
@@ -513,10 +854,10 @@ void Population::ThreadMutation(std::vector<Chromosome>& newChromosomes, SizeTyp
 	}
 }
 
-void Population::ThreadCrossover(std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end)
+void Population::ThreadCrossover(const std::vector<Chromosome>& elites, std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end)
 {
-	SizeType elites = static_cast<SizeType>(std::floor(m_Chromosomes.size() * m_SelectionRatio));
-	Randomizator randomizatorElites(0, elites);
+	SizeType elitesCount = static_cast<SizeType>(std::floor(m_Chromosomes.size() * m_SelectionRatio));
+	Randomizator randomizatorElites(0, elitesCount);
 	Randomizator randomizatorAll(0, static_cast<unsigned>(m_Chromosomes.size() - 1));
 
 	SizeType currentChromosome = start;
@@ -529,8 +870,10 @@ void Population::ThreadCrossover(std::vector<Chromosome>& newChromosomes, SizeTy
 			secondIndex = randomizatorAll.Get();
 		}
 
-		Chromosome& first = m_Chromosomes[firstIndex];
-		Chromosome& second = m_Chromosomes[secondIndex];
+		/// Only the first parent comes from the node local copy. Replicating the whole population per node
+		/// would read all of it remotely once per node and generation, more than the second parents add up to.
+		const Chromosome& first = elites[firstIndex];
+		const Chromosome& second = m_Chromosomes[secondIndex];
 
 		newChromosomes[currentChromosome++] = DoCrossover(first, second);
 		if (currentChromosome < end)
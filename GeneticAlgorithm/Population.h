@@ -1,8 +1,11 @@
 #pragma once
 
 #include "flappy.h"
+#include "GeneSequence.h"
 #include "WaitGroup.hpp"
+#include "PerfCounters.h"
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <thread>
@@ -16,22 +19,60 @@ public:
 	typedef bool Gene;
 	struct Chromosome
 	{
-		std::vector<Gene> Genes;
+		GeneSequence Genes;
 		Fitness Fitness;
 	};
 
+	/// How the first generation is created.
+	struct Seeding
+	{
+		/// Probability of a jump gene in random chromosomes, 0.5 is a fair coin.
+		float JumpProbability;
+		/// Share of the population started from the greedy planner instead of random genes.
+		float PlannerRatio;
+
+		Seeding()
+			: JumpProbability(0.5f)
+			, PlannerRatio(0.f)
+		{
+		}
+	};
+
 	Population(const Population& rhs) = delete;
 	Population& operator=(const Population& rhs) = delete;
 
-	Population()
+	Population();
+
+	/// Takes effect on the next Prepare or FindSolution.
+	void SetSeeding(const Seeding& seeding)
 	{
+		m_Seeding = seeding;
 	}
 
 	Chromosome FindSolution(SizeType populationSize, SizeType chromosomeSize, float selectionRatio, std::shared_ptr<Game>& game);
-private:
+
+	/// Generation by generation interface for driving the population from an external executor, see SolveRun.
+	/// InitializeRange and EvolveRange may run concurrently on disjoint ranges,
+	/// everything else must not overlap with any other call.
+	void Prepare(SizeType populationSize, SizeType chromosomeSize, float selectionRatio, const std::shared_ptr<Game>& game);
+	void InitializeRange(SizeType start, SizeType end);
+	void FinishInitialization();
+	void BeginGeneration();
+	/// Evolves [start, end) of the next generation, the range must not include the elites.
+	void EvolveRange(SizeType start, SizeType end);
+	void EndGeneration();
+
+	SizeType Size() const
+	{
+		return static_cast<SizeType>(m_Chromosomes.size());
+	}
+
+	/// Number of chromosomes carried over unchanged to the next generation.
+	SizeType ElitesCount() const;
+
 	bool FoundSolution() const
 	{
-		return m_Chromosomes[m_Fittest].Fitness == m_Chromosomes[0].Genes.size();
+		return m_Chromosomes[m_Fittest].Fitness == m_Chromosomes[0].Genes.Size();
 	}
 
 	Chromosome GetFittest() const
@@ -39,15 +80,39 @@ private:
 		return m_Chromosomes[m_Fittest];
 	}
 
+private:
 	void SingleThreadRoutine();
 
 	void FindFittest();
 
-	void ThreadInitializeChromosomes(SizeType start, SizeType end);
+	/// Placement and per-generation throughput of one worker thread.
+	/// Aligned to a cache line because every worker updates its own entry.
+	struct alignas(64) Worker
+	{
+		unsigned Node;
+		unsigned Cpu;
+		/// The first worker of a node refreshes the node's copy of the elites.
+		bool NodeLeader;
+		unsigned long long Evaluations;
+		long long BusyNanoseconds;
+		PerfPhases Perf;
+	};
+
+	void PlaceWorkers(unsigned threadsCount);
+	void PinWorker(unsigned worker);
+	void ReplicateElites(unsigned worker);
+	const std::vector<Chromosome>& EliteSource(unsigned worker) const;
+	void ReportNodeThroughput();
+	void ReportPerf(const PerfSample& selection);
+
+	void ThreadInitializeChromosomes(unsigned worker, SizeType start, SizeType end);
 	void MultiThreadInitializeChromosomes(unsigned threadsCount);
 	void MultiThreadRoutine(unsigned threadsCount);
 
-	void RandomizeChromosome(Chromosome& chromosome);
+	/// Chromosomes are seeded from m_Seed and their index, so the result does not depend on the threads count.
+	void RandomizeChromosome(SizeType index);
+	/// Runs the planner once into m_Plan, if the seeding asks for planned chromosomes.
+	void PreparePlan();
 
 	void CalculateFitness();
 	Fitness CalculateFitness(const Chromosome& chromosome);
@@ -61,16 +126,30 @@ private:
 
 	void ThreadCalculateFitness(std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end);
 	void ThreadMutation(std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end);
-	void ThreadCrossover(std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end);
-	void ThreadRoutine(std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end);
+	void ThreadCrossover(const std::vector<Chromosome>& elites, std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end);
+	void ThreadRoutine(unsigned worker, std::vector<Chromosome>& newChromosomes, SizeType start, SizeType end);
 
 	void MultiThreadSelection(std::vector<Chromosome>& newChromosomes);
 
 	std::vector<Chromosome> m_Chromosomes;
+	/// Next generation when driven through BeginGeneration / EndGeneration.
+	std::vector<Chromosome> m_NewChromosomes;
 	SizeType m_ChromosomeSize;
 	std::shared_ptr<Game> m_Game;
 	SizeType m_Fittest;
 	float m_SelectionRatio;
-	WaitGroup m_ThreadsReadyForWorkWaitGroup;
+	Seeding m_Seeding;
+	/// Genes of the greedy planner, every planned chromosome starts as a copy.
+	GeneSequence m_Plan;
+	std::uint64_t m_Seed;
+	/// Alternates between generations, see MultiThreadRoutine.
+	WaitGroup m_ThreadsReadyForWorkWaitGroups[2];
 	WaitGroup m_ThreadsWorkingWaitGroup;
+
+	std::vector<Worker> m_Workers;
+	/// Copy of the elites per NUMA node, first touched by a worker of that node.
+	/// Only the first parent of a crossover is an elite. The second one is drawn from the whole
+	/// population and still read from m_Chromosomes, which may live on another node.
+	std::vector<std::vector<Chromosome>> m_NodeElites;
+	std::vector<std::unique_ptr<WaitGroup>> m_NodeElitesReady;
 };
\ No newline at end of file
@@ -1,16 +1,83 @@
 #include "flappy.h"
+#include "BatchSolver.h"
 #include "Population.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <iostream>
 #include <chrono>
+#include <thread>
 
 static const Population::SizeType POPULATION_SIZE = 10000;
 static const float SELECTION_RATIO = 0.2f;
 
-int main()
+/// Many small levels, each far below the genes of a task of its own, so they all end up in packs.
+static const unsigned BATCH_LEVELS = 512;
+static const Population::SizeType BATCH_POPULATION_SIZE = 200;
+static const unsigned long long BATCH_GENERATIONS = 50;
+
+/// Solves a batch of small levels on one executor and reports how fast the batch went.
+static int SolveBatch()
+{
+	Executor executor(std::thread::hardware_concurrency());
+
+	std::vector<std::shared_ptr<Game>> games;
+	for (unsigned i = 0; i < BATCH_LEVELS; ++i)
+	{
+		games.push_back(std::make_shared<Game>(FPS,
+			HORIZONTAL_VELOCITY,
+			VERTICAL_ACCELERATION,
+			JUMP_ACCELERATION,
+			LevelDescription{ 5.f + i % 16, 100 }));
+	}
+
+	BatchParameters parameters;
+	parameters.PopulationSize = BATCH_POPULATION_SIZE;
+	parameters.SelectionRatio = SELECTION_RATIO;
+	parameters.Budget.WallTime = std::chrono::milliseconds(0);
+	parameters.Budget.Evaluations = BATCH_POPULATION_SIZE * BATCH_GENERATIONS;
+	parameters.Seeding.JumpProbability = 0.3f;
+	parameters.Seeding.PlannerRatio = 0.1f;
+
+	auto start = std::chrono::steady_clock::now();
+
+	unsigned solved = 0;
+	unsigned reported = 0;
+	{
+		BatchSolver solver(executor, parameters);
+		solver.Submit(games);
+
+		BatchResult result;
+		while (solver.NextResult(result))
+		{
+			++reported;
+			if (result.Stats.Status == SolveStatus::Solved)
+			{
+				++solved;
+			}
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	const long long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+	std::cout << "Batch of " << reported << " levels on " << executor.ThreadsCount() << " threads: "
+		<< solved << " solved in " << milliseconds << "ms, "
+		<< static_cast<unsigned long long>(reported * 1000.0 / std::max(milliseconds, 1ll)) << " levels/s\n";
+
+	return reported == BATCH_LEVELS ? 0 : 1;
+}
+
+/// Pass --batch to solve many small levels through BatchSolver instead of one large level.
+int main(int argc, char** argv)
 {
+	if (argc > 1 && std::strcmp(argv[1], "--batch") == 0)
+	{
+		return SolveBatch();
+	}
+
 	auto game = std::make_shared<Game>(FPS,
 		HORIZONTAL_VELOCITY,
 		VERTICAL_ACCELERATION,
@@ -25,4 +92,4 @@ int main()
 		game);
 
 	return 0;
-}
\ No newline at end of file
+}
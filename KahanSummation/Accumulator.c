@@ -0,0 +1,154 @@
+#include "Accumulator.h"
+
+#include <malloc.h>
+#include <math.h>
+
+void KahanAccumulatorReset(KahanAccumulator* accumulator)
+{
+	accumulator->sum.sum = 0.f;
+	accumulator->sum.compensator = 0.f;
+}
+
+void KahanAccumulatorAdd(KahanAccumulator* accumulator, float value)
+{
+	const float compensated_number = value - accumulator->sum.compensator;
+	const float temporary_sum = accumulator->sum.sum + compensated_number;
+
+	accumulator->sum.compensator = (temporary_sum - accumulator->sum.sum) - compensated_number;
+	accumulator->sum.sum = temporary_sum;
+}
+
+void KahanAccumulatorAddBatch(KahanAccumulator* accumulator, const float* sequence, size_t length)
+{
+	accumulator->sum = CombineCompensatedSums(accumulator->sum, SelectKahanSummationKernel()(sequence, length));
+}
+
+void KahanAccumulatorMerge(KahanAccumulator* accumulator, const KahanAccumulator* other)
+{
+	accumulator->sum = CombineCompensatedSums(accumulator->sum, other->sum);
+}
+
+float KahanAccumulatorResult(const KahanAccumulator* accumulator)
+{
+	return CompensatedSumValue(accumulator->sum);
+}
+
+/// Counts value in or, when removing, out of the window if it is not finite. Returns 1 if it was not finite.
+static int CountNonFinite(SlidingWindowSum* window, float value, int removing)
+{
+	size_t* count = NULL;
+
+	if (isnan(value))
+	{
+		count = &window->nans;
+	}
+	else if (isinf(value))
+	{
+		count = value > 0.f ? &window->positive_infinities : &window->negative_infinities;
+	}
+
+	if (count == NULL)
+	{
+		return 0;
+	}
+
+	if (removing)
+	{
+		--*count;
+	}
+	else
+	{
+		++*count;
+	}
+
+	return 1;
+}
+
+int SlidingWindowSumCreate(SlidingWindowSum* window, size_t capacity)
+{
+	ExactAccumulatorReset(&window->accumulator);
+	window->values = capacity > 0 ? (float*)malloc(capacity * sizeof(float)) : NULL;
+	/// A window that failed to be created stays empty, Push and Pop do nothing on it.
+	window->capacity = window->values != NULL ? capacity : 0;
+	window->first = 0;
+	window->count = 0;
+	window->positive_infinities = 0;
+	window->negative_infinities = 0;
+	window->nans = 0;
+
+	return window->values != NULL;
+}
+
+void SlidingWindowSumDestroy(SlidingWindowSum* window)
+{
+	free(window->values);
+	window->values = NULL;
+	window->capacity = 0;
+	window->count = 0;
+}
+
+void SlidingWindowSumPush(SlidingWindowSum* window, float value)
+{
+	if (window->values == NULL)
+	{
+		return;
+	}
+
+	if (window->count == window->capacity)
+	{
+		SlidingWindowSumPop(window);
+	}
+
+	window->values[(window->first + window->count) % window->capacity] = value;
+	++window->count;
+
+	if (!CountNonFinite(window, value, 0))
+	{
+		ExactAccumulatorAdd(&window->accumulator, &value, 1);
+	}
+}
+
+int SlidingWindowSumPop(SlidingWindowSum* window)
+{
+	if (window->values == NULL || window->count == 0)
+	{
+		return 0;
+	}
+
+	const float removed = window->values[window->first];
+	if (!CountNonFinite(window, removed, 1))
+	{
+		const float negated = -removed;
+		ExactAccumulatorAdd(&window->accumulator, &negated, 1);
+	}
+
+	window->first = (window->first + 1) % window->capacity;
+	--window->count;
+
+	return 1;
+}
+
+size_t SlidingWindowSumCount(const SlidingWindowSum* window)
+{
+	return window->count;
+}
+
+float SlidingWindowSumResult(const SlidingWindowSum* window)
+{
+	if (window->nans > 0 || (window->positive_infinities > 0 && window->negative_infinities > 0))
+	{
+		return NAN;
+	}
+
+	if (window->positive_infinities > 0)
+	{
+		return INFINITY;
+	}
+
+	if (window->negative_infinities > 0)
+	{
+		return -INFINITY;
+	}
+
+	return ExactAccumulatorValue(&window->accumulator);
+}
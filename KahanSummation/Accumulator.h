@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ExactSummation.h"
+#include "Summation.h"
+
+/// Running Kahan sum that values can be folded into as they arrive.
+/// Batches go through the vector kernel, accumulators of different shards can be merged,
+/// and in both cases the compensation of either side is kept.
+typedef struct KahanAccumulator
+{
+	CompensatedSum sum;
+} KahanAccumulator;
+
+void KahanAccumulatorReset(KahanAccumulator* accumulator);
+void KahanAccumulatorAdd(KahanAccumulator* accumulator, float value);
+void KahanAccumulatorAddBatch(KahanAccumulator* accumulator, const float* sequence, size_t length);
+void KahanAccumulatorMerge(KahanAccumulator* accumulator, const KahanAccumulator* other);
+float KahanAccumulatorResult(const KahanAccumulator* accumulator);
+
+/// Sum of the last capacity values pushed.
+/// Removing a value by adding its negation to a Kahan sum leaves a little error behind every time,
+/// which adds up over a long stream. The window sums into an ExactAccumulator instead,
+/// where removal is exact, so the result is the correctly rounded sum of the window at any time.
+typedef struct SlidingWindowSum
+{
+	ExactAccumulator accumulator;
+	/// Ring buffer of the values in the window, oldest at first.
+	float* values;
+	size_t capacity;
+	size_t first;
+	size_t count;
+	/// Non-finite values in the window are counted instead, so they can be removed again.
+	size_t positive_infinities;
+	size_t negative_infinities;
+	size_t nans;
+} SlidingWindowSum;
+
+/// Returns 0 if capacity is 0 or the buffer could not be allocated.
+/// The window is empty then, pushing to it does nothing, and it still has to be destroyed.
+int SlidingWindowSumCreate(SlidingWindowSum* window, size_t capacity);
+void SlidingWindowSumDestroy(SlidingWindowSum* window);
+
+/// Adds value, removing the oldest one first if the window is full.
+void SlidingWindowSumPush(SlidingWindowSum* window, float value);
+/// Removes the oldest value. Returns 0 if the window is empty.
+int SlidingWindowSumPop(SlidingWindowSum* window);
+size_t SlidingWindowSumCount(const SlidingWindowSum* window);
+float SlidingWindowSumResult(const SlidingWindowSum* window);
@@ -0,0 +1,190 @@
+#include "AccumulatorChecks.h"
+#include "Accumulator.h"
+#include "ExactSummation.h"
+#include "Generators.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WINDOW_CAPACITY 100
+#define STREAM_LENGTH 10000
+#define CHECK_SEED 7ull
+
+/// Equal values, or both NaN.
+static int SameFloat(float lhs, float rhs)
+{
+	return lhs == rhs || (isnan(lhs) && isnan(rhs));
+}
+
+static unsigned Check(int passed, const char* what, size_t at)
+{
+	if (!passed)
+	{
+		printf("Check failed: %s at %zu\n", what, at);
+	}
+
+	return passed ? 0 : 1;
+}
+
+static unsigned CheckSlidingWindow(const float* stream, size_t length)
+{
+	unsigned failures = 0;
+
+	SlidingWindowSum window;
+	failures += Check(SlidingWindowSumCreate(&window, WINDOW_CAPACITY), "window created", 0);
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		SlidingWindowSumPush(&window, stream[i]);
+
+		const size_t count = i + 1 < WINDOW_CAPACITY ? i + 1 : WINDOW_CAPACITY;
+		const float expected = ExactSummation(stream + i + 1 - count, count);
+
+		failures += Check(SlidingWindowSumCount(&window) == count, "window count", i);
+		failures += Check(SameFloat(SlidingWindowSumResult(&window), expected), "window sum", i);
+	}
+
+	/// Draining the window from the oldest value on.
+	for (size_t left = WINDOW_CAPACITY; left > 0; --left)
+	{
+		const float expected = ExactSummation(stream + length - left, left);
+		failures += Check(SameFloat(SlidingWindowSumResult(&window), expected), "drained window sum", left);
+		failures += Check(SlidingWindowSumPop(&window), "pop", left);
+	}
+
+	failures += Check(!SlidingWindowSumPop(&window), "pop of an empty window", 0);
+	failures += Check(SlidingWindowSumResult(&window) == 0.f, "empty window sum", 0);
+
+	SlidingWindowSumDestroy(&window);
+
+	/// A window without room stays usable as an empty one.
+	failures += Check(!SlidingWindowSumCreate(&window, 0), "window of capacity 0 rejected", 0);
+	SlidingWindowSumPush(&window, 1.f);
+	failures += Check(!SlidingWindowSumPop(&window), "pop of a rejected window", 0);
+	failures += Check(SlidingWindowSumCount(&window) == 0, "rejected window count", 0);
+	SlidingWindowSumDestroy(&window);
+
+	return failures;
+}
+
+/// Distance between result and the exact sum, in units of the last place of the exact sum rounded to float.
+static double UlpsOff(float result, float exact)
+{
+	const double ulp = (double)nextafterf(fabsf(exact), INFINITY) - (double)fabsf(exact);
+	return fabs((double)result - (double)exact) / ulp;
+}
+
+/// The merged sum must be closer to the exact sum than the naive sum of the same shards, which is what
+/// it would be without the compensators, and within max_ulps of it. Sequences where Kahan itself loses
+/// the small values, such as the adversarial one, pass INFINITY and are only held to the first check.
+static unsigned CheckKahanMerge(const float* sequence, size_t length, double max_ulps)
+{
+	const size_t shards[] = { 1, 7, 1000, 4096, 65536 };
+	unsigned failures = 0;
+
+	const float exact = ExactSummation(sequence, length);
+
+	float naive = 0.f;
+	for (size_t i = 0; i < length; ++i)
+	{
+		naive += sequence[i];
+	}
+
+	KahanAccumulator one_shot;
+	KahanAccumulatorReset(&one_shot);
+	KahanAccumulatorAddBatch(&one_shot, sequence, length);
+	const double one_shot_ulps = UlpsOff(KahanAccumulatorResult(&one_shot), exact);
+	failures += Check(one_shot_ulps < UlpsOff(naive, exact) && one_shot_ulps <= max_ulps, "one-shot kahan sum", length);
+
+	for (size_t s = 0; s < sizeof(shards) / sizeof(shards[0]); ++s)
+	{
+		KahanAccumulator merged;
+		KahanAccumulatorReset(&merged);
+
+		ExactAccumulator exact_merged;
+		ExactAccumulatorReset(&exact_merged);
+
+		float naive_merged = 0.f;
+
+		/// Every other shard is added value by value, the rest as a batch.
+		for (size_t begin = 0, shard = 0; begin < length; begin += shards[s], ++shard)
+		{
+			const size_t shard_length = length - begin < shards[s] ? length - begin : shards[s];
+
+			KahanAccumulator part;
+			KahanAccumulatorReset(&part);
+
+			float naive_part = 0.f;
+			for (size_t i = 0; i < shard_length; ++i)
+			{
+				naive_part += sequence[begin + i];
+			}
+			naive_merged += naive_part;
+
+			if (shard & 1)
+			{
+				for (size_t i = 0; i < shard_length; ++i)
+				{
+					KahanAccumulatorAdd(&part, sequence[begin + i]);
+				}
+			}
+			else
+			{
+				KahanAccumulatorAddBatch(&part, sequence + begin, shard_length);
+			}
+
+			KahanAccumulatorMerge(&merged, &part);
+
+			ExactAccumulator exact_part;
+			ExactAccumulatorReset(&exact_part);
+			ExactAccumulatorAdd(&exact_part, sequence + begin, shard_length);
+			ExactAccumulatorMerge(&exact_merged, &exact_part);
+		}
+
+		const double merged_ulps = UlpsOff(KahanAccumulatorResult(&merged), exact);
+		failures += Check(merged_ulps < UlpsOff(naive_merged, exact), "merged kahan sum beats naive", shards[s]);
+		failures += Check(merged_ulps <= max_ulps, "merged kahan sum ulps", shards[s]);
+		failures += Check(ExactAccumulatorValue(&exact_merged) == exact, "merged exact sum", shards[s]);
+	}
+
+	return failures;
+}
+
+unsigned RunAccumulatorChecks(void)
+{
+	const size_t MERGE_LENGTH = 300000;
+	unsigned failures = 0;
+
+	float* stream = AllocateFloatSequence(STREAM_LENGTH);
+	float* sequence = AllocateFloatSequence(MERGE_LENGTH);
+	if (stream == NULL || sequence == NULL)
+	{
+		printf("Could not allocate the checked sequences\n");
+		FreeFloatSequence(stream);
+		FreeFloatSequence(sequence);
+		return 1;
+	}
+
+	/// Heavy tailed values, where removing from a running Kahan sum would drift, with non-finite values
+	/// entering and leaving the window: an infinity alone, both infinities, and a NaN among them.
+	GenerateHeavyTailedFloatSequence(stream, STREAM_LENGTH, CHECK_SEED);
+	stream[1000] = INFINITY;
+	stream[3000] = -INFINITY;
+	stream[3050] = INFINITY;
+	stream[5000] = NAN;
+	stream[5020] = -INFINITY;
+	failures += CheckSlidingWindow(stream, STREAM_LENGTH);
+
+	/// Kahan drops the small value between +x and -x, only the merges recover some of the sum.
+	GenerateAdversarialFloatSequence(sequence, MERGE_LENGTH, CHECK_SEED);
+	failures += CheckKahanMerge(sequence, MERGE_LENGTH, INFINITY);
+
+	GenerateHeavyTailedFloatSequence(sequence, MERGE_LENGTH, CHECK_SEED);
+	failures += CheckKahanMerge(sequence, MERGE_LENGTH, 2.0);
+
+	FreeFloatSequence(stream);
+	FreeFloatSequence(sequence);
+
+	return failures;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+/// Checks the sliding window against an exact sum of the same values, with infinities and NaNs
+/// entering and leaving it, and merged shards of Kahan and exact accumulators against one-shot sums.
+/// Prints every failed check and returns their count.
+unsigned RunAccumulatorChecks(void);
@@ -0,0 +1,177 @@
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "Benchmark.h"
+#include "ExactSummation.h"
+#include "Generators.h"
+#include "ParallelSummation.h"
+#include "Summation.h"
+#include "Threads.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/// Every measurement repeats the summation until it ran at least this long.
+#define MIN_MEASURE_SECONDS 0.2
+/// Fixed, so every run measures the same inputs.
+#define BENCHMARK_SEED 20240601ull
+
+typedef float (*Summation)(const float* sequence, size_t length);
+
+typedef struct NamedSummation
+{
+	const char* name;
+	Summation summation;
+} NamedSummation;
+
+typedef struct NamedGenerator
+{
+	const char* name;
+	FloatSequenceGenerator generator;
+} NamedGenerator;
+
+static double GetSeconds(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+static float Naive(const float* sequence, size_t length)
+{
+	float sum = 0.f;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		sum += sequence[i];
+	}
+
+	return sum;
+}
+
+static float KahanScalar(const float* sequence, size_t length)
+{
+	return CompensatedSumValue(KahanSummationScalar(sequence, length));
+}
+
+static float KahanVectorized(const float* sequence, size_t length)
+{
+	return CompensatedSumValue(SelectKahanSummationKernel()(sequence, length));
+}
+
+static float KahanParallel(const float* sequence, size_t length)
+{
+	return CompensatedSumValue(ParallelKahanSummation(sequence, length, GetProcessorsCount()));
+}
+
+/// Distance between result and the exact sum, in units of the last place of the correctly rounded sum.
+static double UlpError(const float* sequence, size_t length, float result)
+{
+	ExactAccumulator accumulator;
+
+	ExactAccumulatorReset(&accumulator);
+	ExactAccumulatorAdd(&accumulator, sequence, length);
+
+	const float reference = fabsf(ExactAccumulatorValue(&accumulator));
+	if (isinf(reference) || isnan(reference) || isinf(result) || isnan(result))
+	{
+		return reference == fabsf(result) ? 0.0 : INFINITY;
+	}
+
+	const float negated_result = -result;
+	ExactAccumulatorAdd(&accumulator, &negated_result, 1);
+
+	const double ulp = (double)nextafterf(reference, INFINITY) - (double)reference;
+
+	return fabs(ExactAccumulatorApproximation(&accumulator)) / ulp;
+}
+
+/// Returns GB/s and stores the result of the last run.
+static double MeasureThroughput(Summation summation, const float* sequence, size_t length, float* result)
+{
+	unsigned runs = 0;
+	const double start = GetSeconds();
+	double elapsed = 0.0;
+
+	do
+	{
+		*result = summation(sequence, length);
+		++runs;
+		elapsed = GetSeconds() - start;
+	} while (elapsed < MIN_MEASURE_SECONDS);
+
+	return (double)length * sizeof(float) * runs / elapsed * 1e-9;
+}
+
+void RunSummationBenchmark(void)
+{
+	const NamedSummation summations[] =
+	{
+		{ "naive", Naive },
+		{ "kahan", KahanScalar },
+		{ "kahan vectorized", KahanVectorized },
+		{ "kahan parallel", KahanParallel },
+		{ "neumaier", NeumaierSummation },
+		{ "pairwise", PairwiseSummation },
+		{ "double", DoubleAccumulatorSummation },
+		{ "exact", ExactSummation },
+	};
+
+	const NamedGenerator generators[] =
+	{
+		{ "random", GenerateRandomFloatSequence },
+		{ "incremental", GenerateIncrementalFloatSequence },
+		{ "equal", GenerateEqualFloatSequence },
+		{ "adversarial", GenerateAdversarialFloatSequence },
+		{ "heavy tailed", GenerateHeavyTailedFloatSequence },
+	};
+
+	const size_t lengths[] = { 1000, 100000, 10000000, 100000000 };
+
+	const size_t summations_count = sizeof(summations) / sizeof(summations[0]);
+	const size_t generators_count = sizeof(generators) / sizeof(generators[0]);
+	const size_t lengths_count = sizeof(lengths) / sizeof(lengths[0]);
+
+	printf("%-12s %10s %-18s %10s %12s\n", "generator", "length", "summation", "GB/s", "ULP error");
+
+	for (size_t l = 0; l < lengths_count; ++l)
+	{
+		float* sequence = AllocateFloatSequence(lengths[l]);
+		if (sequence == NULL)
+		{
+			printf("Could not allocate %zu floats, skipping\n", lengths[l]);
+			continue;
+		}
+
+		for (size_t g = 0; g < generators_count; ++g)
+		{
+			generators[g].generator(sequence, lengths[l], BENCHMARK_SEED);
+
+			for (size_t s = 0; s < summations_count; ++s)
+			{
+				float result = 0.f;
+				const double throughput = MeasureThroughput(summations[s].summation, sequence, lengths[l], &result);
+				const double error = UlpError(sequence, lengths[l], result);
+
+				printf("%-12s %10zu %-18s %10.2f %12.3g\n", generators[g].name, lengths[l], summations[s].name, throughput, error);
+			}
+		}
+
+		FreeFloatSequence(sequence);
+	}
+}
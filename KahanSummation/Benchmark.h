@@ -0,0 +1,5 @@
+#pragma once
+
+/// Times every summation on every generator over several lengths and prints
+/// the throughput in GB/s and the error in ULPs of the exact sum.
+void RunSummationBenchmark(void);
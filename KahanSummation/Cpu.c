@@ -0,0 +1,101 @@
+#include "Cpu.h"
+
+#if CPU_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if CPU_X86
+static void Cpuid(unsigned leaf, unsigned subleaf, unsigned registers[4])
+{
+#if defined(_MSC_VER)
+	int values[4];
+	__cpuidex(values, (int)leaf, (int)subleaf);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		registers[i] = (unsigned)values[i];
+	}
+#else
+	registers[0] = registers[1] = registers[2] = registers[3] = 0;
+	__get_cpuid_count(leaf, subleaf, &registers[0], &registers[1], &registers[2], &registers[3]);
+#endif
+}
+
+static unsigned long long ReadXcr0(void)
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned eax = 0;
+	unsigned edx = 0;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+static unsigned DetectCpuFeatures(void)
+{
+	unsigned features = 0;
+	unsigned registers[4];
+
+	Cpuid(0, 0, registers);
+	const unsigned max_leaf = registers[0];
+
+	Cpuid(1, 0, registers);
+	if (registers[3] & (1u << 26))
+	{
+		features |= CPU_FEATURE_SSE2;
+	}
+
+	const int osxsave = (registers[2] & (1u << 27)) != 0;
+	if (!osxsave || max_leaf < 7)
+	{
+		return features;
+	}
+
+	const unsigned long long xcr0 = ReadXcr0();
+	/// XMM and YMM state
+	const int ymm_enabled = (xcr0 & 0x6) == 0x6;
+	/// Opmask, upper ZMM and high ZMM state on top of that
+	const int zmm_enabled = (xcr0 & 0xE6) == 0xE6;
+
+	Cpuid(7, 0, registers);
+	if (ymm_enabled && (registers[1] & (1u << 5)))
+	{
+		features |= CPU_FEATURE_AVX2;
+	}
+
+	if (zmm_enabled && (registers[1] & (1u << 16)))
+	{
+		features |= CPU_FEATURE_AVX512F;
+	}
+
+	return features;
+}
+#endif
+
+/// Marks the word as filled in, so a CPU without any of the features is not detected again.
+#define CPU_FEATURES_DETECTED (1u << 31)
+
+unsigned GetCpuFeatures(void)
+{
+	/// A single word written once with the full result. Threads calling for the first time at the same
+	/// time each detect the same value and store it, none of them can see a half written state.
+	static volatile unsigned features = 0;
+
+	unsigned value = features;
+	if ((value & CPU_FEATURES_DETECTED) == 0)
+	{
+		value = CPU_FEATURES_DETECTED;
+#if CPU_X86
+		value |= DetectCpuFeatures();
+#endif
+		features = value;
+	}
+
+	return value & ~CPU_FEATURES_DETECTED;
+}
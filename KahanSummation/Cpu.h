@@ -0,0 +1,28 @@
+#pragma once
+
+/// Instruction sets usable on the running machine, checked through cpuid and,
+/// for the wide registers, through xgetbv so that the OS also saves them.
+
+#define CPU_FEATURE_SSE2 (1u << 0)
+#define CPU_FEATURE_AVX2 (1u << 1)
+#define CPU_FEATURE_AVX512F (1u << 2)
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86 1
+#else
+#define CPU_X86 0
+#endif
+
+/// GCC and Clang only emit wide instructions in functions marked for them, MSVC needs no marker.
+#if CPU_X86 && defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
+/// Bitmask of CPU_FEATURE_* values, detected on the first call. Safe to call from several threads.
+unsigned GetCpuFeatures(void);
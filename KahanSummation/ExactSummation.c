@@ -0,0 +1,196 @@
+#include "ExactSummation.h"
+
+#include <math.h>
+#include <string.h>
+
+#define DIGIT_BITS 32
+#define DIGIT_MASK 0xFFFFFFFFll
+/// Each addition moves a limb by less than 2^32, so 2^30 of them cannot overflow it.
+#define MAX_PENDING (1u << 30)
+/// Weight of bit 0 of the fixed point integer, the smallest subnormal.
+#define LOWEST_EXPONENT -149
+
+static void PropagateCarries(long long* limbs)
+{
+	for (int i = 0; i < EXACT_LIMBS - 1; ++i)
+	{
+		const long long carry = limbs[i] >> DIGIT_BITS;
+
+		limbs[i] &= DIGIT_MASK;
+		limbs[i + 1] += carry;
+	}
+}
+
+void ExactAccumulatorReset(ExactAccumulator* accumulator)
+{
+	memset(accumulator, 0, sizeof(*accumulator));
+}
+
+void ExactAccumulatorAdd(ExactAccumulator* accumulator, const float* sequence, size_t length)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		unsigned bits;
+		memcpy(&bits, &sequence[i], sizeof(bits));
+
+		const unsigned exponent = (bits >> 23) & 0xFF;
+		long long mantissa = bits & 0x7FFFFF;
+
+		if (exponent == 0xFF)
+		{
+			accumulator->special = accumulator->has_special ? accumulator->special + sequence[i] : sequence[i];
+			accumulator->has_special = 1;
+			continue;
+		}
+
+		/// Subnormals share the weight of the lowest normal exponent, without the implicit bit.
+		const unsigned position = exponent == 0 ? 0 : exponent - 1;
+		if (exponent != 0)
+		{
+			mantissa |= 0x800000;
+		}
+		if (bits >> 31)
+		{
+			mantissa = -mantissa;
+		}
+
+		const unsigned limb = position / DIGIT_BITS;
+		const long long shifted = mantissa * (1ll << (position % DIGIT_BITS));
+
+		accumulator->limbs[limb] += shifted & DIGIT_MASK;
+		accumulator->limbs[limb + 1] += shifted >> DIGIT_BITS;
+
+		if (++accumulator->pending == MAX_PENDING)
+		{
+			PropagateCarries(accumulator->limbs);
+			accumulator->pending = 0;
+		}
+	}
+}
+
+void ExactAccumulatorMerge(ExactAccumulator* accumulator, const ExactAccumulator* other)
+{
+	long long limbs[EXACT_LIMBS];
+	memcpy(limbs, other->limbs, sizeof(limbs));
+	PropagateCarries(limbs);
+
+	/// After propagation every digit but the last is below 2^32, so merging counts as one addition.
+	PropagateCarries(accumulator->limbs);
+	for (int i = 0; i < EXACT_LIMBS; ++i)
+	{
+		accumulator->limbs[i] += limbs[i];
+	}
+	accumulator->pending = 1;
+
+	if (other->has_special)
+	{
+		accumulator->special = accumulator->has_special ? accumulator->special + other->special : other->special;
+		accumulator->has_special = 1;
+	}
+}
+
+/// Propagates the carries of a copy of the limbs and makes it non-negative.
+/// Returns 1 if the value is negative.
+static int Magnitude(const ExactAccumulator* accumulator, long long* limbs)
+{
+	memcpy(limbs, accumulator->limbs, sizeof(accumulator->limbs));
+	PropagateCarries(limbs);
+
+	if (limbs[EXACT_LIMBS - 1] >= 0)
+	{
+		return 0;
+	}
+
+	for (int i = 0; i < EXACT_LIMBS; ++i)
+	{
+		limbs[i] = -limbs[i];
+	}
+	PropagateCarries(limbs);
+
+	return 1;
+}
+
+static unsigned GetBit(const long long* limbs, int bit)
+{
+	return (unsigned)(limbs[bit / DIGIT_BITS] >> (bit % DIGIT_BITS)) & 1u;
+}
+
+float ExactAccumulatorValue(const ExactAccumulator* accumulator)
+{
+	if (accumulator->has_special)
+	{
+		return accumulator->special;
+	}
+
+	long long limbs[EXACT_LIMBS];
+	const int negative = Magnitude(accumulator, limbs);
+	const float sign = negative ? -1.f : 1.f;
+
+	/// The last limb only collects carries, anything in it is far beyond the float range.
+	if (limbs[EXACT_LIMBS - 1] != 0)
+	{
+		return sign * HUGE_VALF;
+	}
+
+	int highest = (EXACT_LIMBS - 1) * DIGIT_BITS - 1;
+	while (highest >= 0 && GetBit(limbs, highest) == 0)
+	{
+		--highest;
+	}
+
+	/// Up to 24 significant bits the value is exact, subnormals included.
+	if (highest < 24)
+	{
+		return sign * ldexpf((float)limbs[0], LOWEST_EXPONENT);
+	}
+
+	unsigned mantissa = 0;
+	for (int bit = highest; bit > highest - 24; --bit)
+	{
+		mantissa = (mantissa << 1) | GetBit(limbs, bit);
+	}
+
+	const unsigned round = GetBit(limbs, highest - 24);
+	unsigned sticky = 0;
+	for (int bit = highest - 25; bit >= 0 && sticky == 0; --bit)
+	{
+		sticky = GetBit(limbs, bit);
+	}
+
+	if (round && (sticky || (mantissa & 1u)))
+	{
+		++mantissa;
+	}
+
+	/// Exact unless the rounded value is past FLT_MAX, where ldexpf gives infinity.
+	return sign * ldexpf((float)mantissa, highest - 23 + LOWEST_EXPONENT);
+}
+
+double ExactAccumulatorApproximation(const ExactAccumulator* accumulator)
+{
+	if (accumulator->has_special)
+	{
+		return accumulator->special;
+	}
+
+	long long limbs[EXACT_LIMBS];
+	const int negative = Magnitude(accumulator, limbs);
+
+	double value = 0.0;
+	for (int i = EXACT_LIMBS - 1; i >= 0; --i)
+	{
+		value += ldexp((double)limbs[i], i * DIGIT_BITS + LOWEST_EXPONENT);
+	}
+
+	return negative ? -value : value;
+}
+
+float ExactSummation(const float* sequence, size_t length)
+{
+	ExactAccumulator accumulator;
+
+	ExactAccumulatorReset(&accumulator);
+	ExactAccumulatorAdd(&accumulator, sequence, length);
+
+	return ExactAccumulatorValue(&accumulator);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stddef.h>
+
+/// Every finite float is an integer multiple of 2^-149 below 2^128, so a fixed point
+/// integer wide enough for that range holds any sum of floats without rounding.
+/// The integer is kept in signed 32 bit digits stored in 64 bit limbs, which leaves room
+/// for 2^30 additions before the carries have to be propagated, see MAX_PENDING.
+#define EXACT_LIMBS 10
+
+typedef struct ExactAccumulator
+{
+	long long limbs[EXACT_LIMBS];
+	/// Additions since the carries were last propagated.
+	unsigned pending;
+	/// Infinities and NaNs cannot be held in the limbs, they are summed here instead.
+	float special;
+	int has_special;
+} ExactAccumulator;
+
+void ExactAccumulatorReset(ExactAccumulator* accumulator);
+void ExactAccumulatorAdd(ExactAccumulator* accumulator, const float* sequence, size_t length);
+void ExactAccumulatorMerge(ExactAccumulator* accumulator, const ExactAccumulator* other);
+
+/// The exact sum rounded to nearest, ties to even.
+float ExactAccumulatorValue(const ExactAccumulator* accumulator);
+
+/// The exact sum converted to double, close enough to measure the error of other summations.
+double ExactAccumulatorApproximation(const ExactAccumulator* accumulator);
+
+/// Correctly rounded sum of the sequence.
+float ExactSummation(const float* sequence, size_t length);
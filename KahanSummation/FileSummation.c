@@ -0,0 +1,237 @@
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200112L
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "FileSummation.h"
+#include "Accumulator.h"
+
+#include <malloc.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// Bytes mapped at once. Keeps the address space use bounded, also for 32 bit builds,
+/// and is a multiple of the mapping granularity of both Windows and POSIX.
+#define WINDOW_BYTES ((unsigned long long)1 << 26)
+
+struct FloatFileFollower
+{
+#if defined(_WIN32)
+	HANDLE file;
+#else
+	int file;
+#endif
+	KahanAccumulator accumulator;
+	/// Always a multiple of sizeof(float).
+	unsigned long long consumed_bytes;
+};
+
+#if defined(_WIN32)
+static unsigned long long GetGranularity(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwAllocationGranularity;
+}
+
+static int OpenFloatFile(FloatFileFollower* follower, const char* path)
+{
+	/// FILE_SHARE_WRITE lets the producer keep appending while the file is followed.
+	follower->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	return follower->file != INVALID_HANDLE_VALUE;
+}
+
+static void CloseFloatFile(FloatFileFollower* follower)
+{
+	CloseHandle(follower->file);
+}
+
+static int GetFloatFileSize(const FloatFileFollower* follower, unsigned long long* size)
+{
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(follower->file, &file_size))
+	{
+		return 0;
+	}
+
+	*size = (unsigned long long)file_size.QuadPart;
+	return 1;
+}
+
+/// A mapping object covers the file at the size it had when created, so a new one is made per call.
+static int SumRange(FloatFileFollower* follower, unsigned long long size)
+{
+	HANDLE mapping = CreateFileMappingA(follower->file, NULL, PAGE_READONLY, (DWORD)(size >> 32), (DWORD)size, NULL);
+	if (mapping == NULL)
+	{
+		return 0;
+	}
+
+	const unsigned long long granularity = GetGranularity();
+	int succeeded = 1;
+
+	while (follower->consumed_bytes + sizeof(float) <= size)
+	{
+		const unsigned long long start = follower->consumed_bytes - follower->consumed_bytes % granularity;
+		const unsigned long long end = start + WINDOW_BYTES < size ? start + WINDOW_BYTES : size;
+
+		const unsigned char* view = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, (SIZE_T)(end - start));
+		if (view == NULL)
+		{
+			succeeded = 0;
+			break;
+		}
+
+		const size_t length = (size_t)((end - follower->consumed_bytes) / sizeof(float));
+		const float* sequence = (const float*)(view + (follower->consumed_bytes - start));
+
+		KahanAccumulatorAddBatch(&follower->accumulator, sequence, length);
+		follower->consumed_bytes += length * sizeof(float);
+
+		UnmapViewOfFile(view);
+	}
+
+	CloseHandle(mapping);
+	return succeeded;
+}
+#else
+static unsigned long long GetGranularity(void)
+{
+	const long page = sysconf(_SC_PAGESIZE);
+	return page > 0 ? (unsigned long long)page : 4096;
+}
+
+static int OpenFloatFile(FloatFileFollower* follower, const char* path)
+{
+	follower->file = open(path, O_RDONLY);
+	return follower->file >= 0;
+}
+
+static void CloseFloatFile(FloatFileFollower* follower)
+{
+	close(follower->file);
+}
+
+static int GetFloatFileSize(const FloatFileFollower* follower, unsigned long long* size)
+{
+	struct stat status;
+	if (fstat(follower->file, &status) != 0)
+	{
+		return 0;
+	}
+
+	*size = (unsigned long long)status.st_size;
+	return 1;
+}
+
+static int SumRange(FloatFileFollower* follower, unsigned long long size)
+{
+	const unsigned long long granularity = GetGranularity();
+
+	while (follower->consumed_bytes + sizeof(float) <= size)
+	{
+		const unsigned long long start = follower->consumed_bytes - follower->consumed_bytes % granularity;
+		const unsigned long long end = start + WINDOW_BYTES < size ? start + WINDOW_BYTES : size;
+		const size_t window_bytes = (size_t)(end - start);
+
+		void* view = mmap(NULL, window_bytes, PROT_READ, MAP_SHARED, follower->file, (off_t)start);
+		if (view == MAP_FAILED)
+		{
+			return 0;
+		}
+
+		/// Starts readahead of the whole window, the kernel sums the front while the rest is read in.
+		posix_madvise(view, window_bytes, POSIX_MADV_SEQUENTIAL);
+		posix_madvise(view, window_bytes, POSIX_MADV_WILLNEED);
+
+		const size_t length = (size_t)((end - follower->consumed_bytes) / sizeof(float));
+		const float* sequence = (const float*)((const unsigned char*)view + (follower->consumed_bytes - start));
+
+		KahanAccumulatorAddBatch(&follower->accumulator, sequence, length);
+		follower->consumed_bytes += length * sizeof(float);
+
+		munmap(view, window_bytes);
+	}
+
+	return 1;
+}
+#endif
+
+FloatFileFollower* OpenFloatFileFollower(const char* path)
+{
+	FloatFileFollower* follower = (FloatFileFollower*)malloc(sizeof(FloatFileFollower));
+	if (follower == NULL)
+	{
+		return NULL;
+	}
+
+	if (!OpenFloatFile(follower, path))
+	{
+		free(follower);
+		return NULL;
+	}
+
+	KahanAccumulatorReset(&follower->accumulator);
+	follower->consumed_bytes = 0;
+
+	return follower;
+}
+
+void CloseFloatFileFollower(FloatFileFollower* follower)
+{
+	if (follower == NULL)
+	{
+		return;
+	}
+
+	CloseFloatFile(follower);
+	free(follower);
+}
+
+int FollowFloatFile(FloatFileFollower* follower)
+{
+	unsigned long long size = 0;
+	if (!GetFloatFileSize(follower, &size))
+	{
+		return 0;
+	}
+
+	if (follower->consumed_bytes + sizeof(float) > size)
+	{
+		return 1;
+	}
+
+	return SumRange(follower, size);
+}
+
+CompensatedSum FloatFileFollowerSum(const FloatFileFollower* follower)
+{
+	return follower->accumulator.sum;
+}
+
+unsigned long long FloatFileFollowerCount(const FloatFileFollower* follower)
+{
+	return follower->consumed_bytes / sizeof(float);
+}
+
+int SumFloatFile(const char* path, CompensatedSum* result)
+{
+	FloatFileFollower* follower = OpenFloatFileFollower(path);
+	if (follower == NULL)
+	{
+		return 0;
+	}
+
+	const int succeeded = FollowFloatFile(follower);
+	*result = FloatFileFollowerSum(follower);
+
+	CloseFloatFileFollower(follower);
+	return succeeded;
+}
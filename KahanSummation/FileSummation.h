@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Summation.h"
+
+/// Sums a file of native endian floats straight from the page cache, the file is memory mapped
+/// in windows and every window is fed to the Kahan kernel without copying.
+/// A follower keeps its position, so a file that is still being appended to can be summed
+/// as it grows, each call only reading what was added since the previous one.
+typedef struct FloatFileFollower FloatFileFollower;
+
+/// Returns NULL if the file cannot be opened.
+FloatFileFollower* OpenFloatFileFollower(const char* path);
+void CloseFloatFileFollower(FloatFileFollower* follower);
+
+/// Adds the floats appended since the previous call to the running sum.
+/// A float that is only partially written yet is left for the next call.
+/// Returns 0 on an I/O error, the running sum stays at the last complete window in that case.
+int FollowFloatFile(FloatFileFollower* follower);
+
+CompensatedSum FloatFileFollowerSum(const FloatFileFollower* follower);
+/// Floats summed so far.
+unsigned long long FloatFileFollowerCount(const FloatFileFollower* follower);
+
+/// Sums the whole file once. Returns 0 if it could not be read.
+int SumFloatFile(const char* path, CompensatedSum* result);
@@ -0,0 +1,295 @@
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "Generators.h"
+#include "Cpu.h"
+#include "Threads.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if CPU_X86
+#include <immintrin.h>
+#endif
+
+/// Elements per block, same granularity as the parallel summation.
+#define BLOCK_LENGTH ((size_t)1 << 16)
+/// Random words produced at once, small enough to stay in L1.
+#define CHUNK_LENGTH 1024
+#define SEQUENCE_ALIGNMENT 64
+
+typedef void (*RandomBitsKernel)(uint32_t* bits, size_t length, uint32_t counter, uint64_t key);
+
+/// Writes the block [begin, begin + length) of the sequence, drawing random bits from random_bits.
+typedef void (*BlockGenerator)(float* block, size_t begin, size_t length, uint64_t key, RandomBitsKernel random_bits);
+
+typedef struct ParallelGeneration
+{
+	BlockGenerator generator;
+	/// Selected once for the whole sequence.
+	RandomBitsKernel random_bits;
+	float* sequence;
+	size_t length;
+	size_t blocks_count;
+	uint64_t seed;
+} ParallelGeneration;
+
+static uint64_t SplitMix64(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+/// lowbias32 by Chris Wellons, a 32 bit integer hash with good avalanche.
+static uint32_t Hash32(uint32_t value)
+{
+	value ^= value >> 16;
+	value *= 0x7FEB352Du;
+	value ^= value >> 15;
+	value *= 0x846CA68Bu;
+	value ^= value >> 16;
+	return value;
+}
+
+/// bits[i] = Hash32((counter + i) * golden + key low) ^ key high.
+static void RandomBitsScalar(uint32_t* bits, size_t length, uint32_t counter, uint64_t key)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		bits[i] = Hash32((counter + (uint32_t)i) * 0x9E3779B9u + (uint32_t)key) ^ (uint32_t)(key >> 32);
+	}
+}
+
+TARGET_AVX2 static void RandomBitsAvx2(uint32_t* bits, size_t length, uint32_t counter, uint64_t key)
+{
+#if CPU_X86
+	const __m256i golden = _mm256_set1_epi32((int)0x9E3779B9u);
+	const __m256i low_key = _mm256_set1_epi32((int)(uint32_t)key);
+	const __m256i high_key = _mm256_set1_epi32((int)(uint32_t)(key >> 32));
+	const __m256i first_multiplier = _mm256_set1_epi32(0x7FEB352D);
+	const __m256i second_multiplier = _mm256_set1_epi32((int)0x846CA68Bu);
+	const __m256i step = _mm256_set1_epi32(8);
+
+	__m256i counters = _mm256_add_epi32(_mm256_set1_epi32((int)counter), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+	size_t i = 0;
+	for (; i + 8 <= length; i += 8)
+	{
+		__m256i value = _mm256_add_epi32(_mm256_mullo_epi32(counters, golden), low_key);
+
+		value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 16));
+		value = _mm256_mullo_epi32(value, first_multiplier);
+		value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 15));
+		value = _mm256_mullo_epi32(value, second_multiplier);
+		value = _mm256_xor_si256(value, _mm256_srli_epi32(value, 16));
+
+		_mm256_storeu_si256((__m256i*)(bits + i), _mm256_xor_si256(value, high_key));
+
+		counters = _mm256_add_epi32(counters, step);
+	}
+
+	RandomBitsScalar(bits + i, length - i, counter + (uint32_t)i, key);
+#else
+	RandomBitsScalar(bits, length, counter, key);
+#endif
+}
+
+static RandomBitsKernel SelectRandomBitsKernel(void)
+{
+	return (GetCpuFeatures() & CPU_FEATURE_AVX2) ? RandomBitsAvx2 : RandomBitsScalar;
+}
+
+/// 24 random bits as a float in [0, 1).
+/// Converted through int32_t, the vector instruction sets before AVX-512 only convert signed integers.
+static float ToUnit(uint32_t bits)
+{
+	return (float)(int32_t)(bits >> 8) * (1.f / 16777216.f);
+}
+
+static void RandomBlock(float* block, size_t begin, size_t length, uint64_t key, RandomBitsKernel random_bits)
+{
+	uint32_t bits[CHUNK_LENGTH];
+
+	(void)begin;
+
+	for (size_t i = 0; i < length; i += CHUNK_LENGTH)
+	{
+		const size_t chunk = length - i < CHUNK_LENGTH ? length - i : CHUNK_LENGTH;
+		random_bits(bits, chunk, (uint32_t)i, key);
+
+		for (size_t k = 0; k < chunk; ++k)
+		{
+			block[i + k] = ToUnit(bits[k]) * 1000.f;
+		}
+	}
+}
+
+static void IncrementalBlock(float* block, size_t begin, size_t length, uint64_t key, RandomBitsKernel random_bits)
+{
+	float base = 0.f;
+	float step = 0.1f;
+
+	(void)key;
+	(void)random_bits;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		block[i] = base + ((begin + i) * step);
+	}
+}
+
+static void EqualBlock(float* block, size_t begin, size_t length, uint64_t key, RandomBitsKernel random_bits)
+{
+	const float VALUE = 0.12345f;
+
+	(void)begin;
+	(void)key;
+	(void)random_bits;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		block[i] = VALUE;
+	}
+}
+
+static void AdversarialBlock(float* block, size_t begin, size_t length, uint64_t key, RandomBitsKernel random_bits)
+{
+	/// Large enough that the small values are below half an ULP of the partial sums a naive loop sees.
+	const float LARGE = 67108864.f;
+
+	uint32_t bits[CHUNK_LENGTH];
+
+	/// Blocks are a multiple of 4 long, so the cancelling pairs never straddle two blocks.
+	(void)begin;
+
+	for (size_t i = 0; i < length; i += CHUNK_LENGTH)
+	{
+		const size_t chunk = length - i < CHUNK_LENGTH ? length - i : CHUNK_LENGTH;
+		random_bits(bits, chunk, (uint32_t)i, key);
+
+		/// Positions 4n and 4n + 2 hold +x and -x, the odd positions hold the small values.
+		for (size_t k = 0; k < chunk; ++k)
+		{
+			const size_t position = i + k;
+			const float large = LARGE * (1.f + ToUnit(bits[k & ~(size_t)3]));
+
+			/// A +x whose -x would fall past the end of the sequence is replaced by a small value too.
+			/// Blocks are a multiple of 4 long, so only the last block can end there.
+			if ((position & 1) || ((position & 2) == 0 && position + 2 >= length))
+			{
+				block[position] = ToUnit(bits[k]);
+			}
+			else
+			{
+				block[position] = (position & 2) ? -large : large;
+			}
+		}
+	}
+}
+
+static void HeavyTailedBlock(float* block, size_t begin, size_t length, uint64_t key, RandomBitsKernel random_bits)
+{
+	uint32_t bits[CHUNK_LENGTH];
+
+	(void)begin;
+
+	for (size_t i = 0; i < length; i += CHUNK_LENGTH)
+	{
+		const size_t chunk = length - i < CHUNK_LENGTH ? length - i : CHUNK_LENGTH;
+		random_bits(bits, chunk, (uint32_t)i, key);
+
+		for (size_t k = 0; k < chunk; ++k)
+		{
+			/// The top 24 bits give u in (0, 1], the lowest bit the sign.
+			const float u = (float)(int32_t)((bits[k] >> 8) + 1) * (1.f / 16777216.f);
+			const float sign = (float)(1 - (int32_t)((bits[k] & 1u) << 1));
+
+			block[i + k] = sign / u;
+		}
+	}
+}
+
+static void GenerateBlocks(void* context, unsigned thread, unsigned threads_count)
+{
+	const ParallelGeneration* generation = (const ParallelGeneration*)context;
+
+	for (size_t block = thread; block < generation->blocks_count; block += threads_count)
+	{
+		const size_t begin = block * BLOCK_LENGTH;
+		const size_t end = begin + BLOCK_LENGTH < generation->length ? begin + BLOCK_LENGTH : generation->length;
+
+		generation->generator(generation->sequence + begin, begin, end - begin, SplitMix64(generation->seed ^ SplitMix64(block)), generation->random_bits);
+	}
+}
+
+static void GenerateParallel(BlockGenerator generator, float* sequence, size_t length, unsigned long long seed)
+{
+	ParallelGeneration generation;
+	generation.generator = generator;
+	generation.random_bits = SelectRandomBitsKernel();
+	generation.sequence = sequence;
+	generation.length = length;
+	generation.blocks_count = (length + BLOCK_LENGTH - 1) / BLOCK_LENGTH;
+	generation.seed = seed;
+
+	unsigned threads_count = GetProcessorsCount();
+	if (threads_count > generation.blocks_count)
+	{
+		threads_count = generation.blocks_count > 0 ? (unsigned)generation.blocks_count : 1;
+	}
+
+	RunParallel(GenerateBlocks, &generation, threads_count);
+}
+
+float* AllocateFloatSequence(size_t length)
+{
+	const size_t bytes = length > 0 ? length * sizeof(float) : sizeof(float);
+
+#if defined(_WIN32)
+	return (float*)_aligned_malloc(bytes, SEQUENCE_ALIGNMENT);
+#else
+	void* sequence = NULL;
+	return posix_memalign(&sequence, SEQUENCE_ALIGNMENT, bytes) == 0 ? (float*)sequence : NULL;
+#endif
+}
+
+void FreeFloatSequence(float* sequence)
+{
+#if defined(_WIN32)
+	_aligned_free(sequence);
+#else
+	free(sequence);
+#endif
+}
+
+void GenerateRandomFloatSequence(float* sequence, size_t length, unsigned long long seed)
+{
+	GenerateParallel(RandomBlock, sequence, length, seed);
+}
+
+void GenerateIncrementalFloatSequence(float* sequence, size_t length, unsigned long long seed)
+{
+	GenerateParallel(IncrementalBlock, sequence, length, seed);
+}
+
+void GenerateEqualFloatSequence(float* sequence, size_t length, unsigned long long seed)
+{
+	GenerateParallel(EqualBlock, sequence, length, seed);
+}
+
+void GenerateAdversarialFloatSequence(float* sequence, size_t length, unsigned long long seed)
+{
+	GenerateParallel(AdversarialBlock, sequence, length, seed);
+}
+
+void GenerateHeavyTailedFloatSequence(float* sequence, size_t length, unsigned long long seed)
+{
+	GenerateParallel(HeavyTailedBlock, sequence, length, seed);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+
+/// Every generator fills the sequence on all processors in fixed blocks.
+/// Random values come from a counter based hash keyed by the seed and the block,
+/// so the same seed gives the same sequence for any thread count.
+typedef void (*FloatSequenceGenerator)(float* sequence, size_t length, unsigned long long seed);
+
+/// 64 byte aligned, for the vector kernels and whole cache lines. Returns NULL on failure.
+float* AllocateFloatSequence(size_t length);
+void FreeFloatSequence(float* sequence);
+
+/// Uniform in [0, 1000).
+void GenerateRandomFloatSequence(float* sequence, size_t length, unsigned long long seed);
+/// 0, 0.1, 0.2, ...
+void GenerateIncrementalFloatSequence(float* sequence, size_t length, unsigned long long seed);
+/// The same value repeated.
+void GenerateEqualFloatSequence(float* sequence, size_t length, unsigned long long seed);
+/// Pairs of large values that cancel exactly, interleaved with small values in [0, 1).
+/// A trailing large value that would be left without its pair is a small value as well.
+/// The exact sum is the sum of the small values, a naive sum loses nearly all of them.
+void GenerateAdversarialFloatSequence(float* sequence, size_t length, unsigned long long seed);
+/// Random sign times 1 / u for u uniform in (0, 1], a Pareto tail with index 1 reaching 2^24.
+void GenerateHeavyTailedFloatSequence(float* sequence, size_t length, unsigned long long seed);
@@ -0,0 +1,84 @@
+#include "ParallelSummation.h"
+#include "Threads.h"
+
+#include <malloc.h>
+
+/// Elements per block, 256 KB of floats, large enough for the vector kernels to run at full speed.
+#define BLOCK_LENGTH ((size_t)1 << 16)
+
+typedef struct BlockSummation
+{
+	SummationKernel kernel;
+	const float* sequence;
+	size_t length;
+	size_t blocks_count;
+	CompensatedSum* partials;
+} BlockSummation;
+
+static CompensatedSum SumBlock(const BlockSummation* summation, size_t block)
+{
+	const size_t begin = block * BLOCK_LENGTH;
+	const size_t end = begin + BLOCK_LENGTH < summation->length ? begin + BLOCK_LENGTH : summation->length;
+
+	return summation->kernel(summation->sequence + begin, end - begin);
+}
+
+/// Blocks are dealt out round-robin, every thread writes only its own partials, so no synchronization is needed.
+static void SumBlocks(void* context, unsigned thread, unsigned threads_count)
+{
+	BlockSummation* summation = (BlockSummation*)context;
+
+	for (size_t block = thread; block < summation->blocks_count; block += threads_count)
+	{
+		summation->partials[block] = SumBlock(summation, block);
+	}
+}
+
+CompensatedSum ParallelKahanSummation(const float* sequence, size_t length, unsigned threads_count)
+{
+	BlockSummation summation;
+	summation.kernel = SelectKahanSummationKernel();
+	summation.sequence = sequence;
+	summation.length = length;
+	summation.blocks_count = (length + BLOCK_LENGTH - 1) / BLOCK_LENGTH;
+	summation.partials = NULL;
+
+	CompensatedSum result = { 0.f, 0.f };
+
+	if (summation.blocks_count > 1)
+	{
+		summation.partials = (CompensatedSum*)malloc(summation.blocks_count * sizeof(CompensatedSum));
+	}
+
+	if (summation.partials == NULL)
+	{
+		/// Same blocks and same merge order as below, only on the calling thread.
+		for (size_t block = 0; block < summation.blocks_count; ++block)
+		{
+			result = block == 0 ? SumBlock(&summation, block) : CombineCompensatedSums(result, SumBlock(&summation, block));
+		}
+
+		return result;
+	}
+
+	if (threads_count == 0)
+	{
+		threads_count = 1;
+	}
+	if (threads_count > summation.blocks_count)
+	{
+		threads_count = (unsigned)summation.blocks_count;
+	}
+
+	RunParallel(SumBlocks, &summation, threads_count);
+
+	result = summation.partials[0];
+	for (size_t block = 1; block < summation.blocks_count; ++block)
+	{
+		result = CombineCompensatedSums(result, summation.partials[block]);
+	}
+
+	free(summation.partials);
+
+	return result;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Summation.h"
+
+/// Kahan summation over threads_count threads.
+/// The sequence is cut into blocks of a fixed size that does not depend on threads_count,
+/// every block is summed on its own and the block results are combined in block order.
+/// The result is therefore bit-identical for any threads_count.
+CompensatedSum ParallelKahanSummation(const float* sequence, size_t length, unsigned threads_count);
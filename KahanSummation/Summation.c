@@ -0,0 +1,321 @@
+#include "Summation.h"
+#include "Cpu.h"
+
+#include <math.h>
+
+#if CPU_X86
+#include <immintrin.h>
+#endif
+
+/// Kahan summation of the remaining elements, continuing from a running sum and compensator.
+static void KahanContinue(const float* sequence, size_t length, float* sum, float* compensator)
+{
+	float running_sum = *sum;
+	float running_compensator = *compensator;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		const float compensated_number = sequence[i] - running_compensator;
+		const float temporary_sum = running_sum + compensated_number;
+
+		running_compensator = (temporary_sum - running_sum) - compensated_number;
+		running_sum = temporary_sum;
+	}
+
+	*sum = running_sum;
+	*compensator = running_compensator;
+}
+
+/// Adds the lane sums and subtracts the lane compensators with Neumaier's variant,
+/// which unlike plain Kahan stays exact when a term is larger than the running sum.
+/// The result is returned as a Kahan pair, the value being sum - compensator.
+static void ReduceLanes(const float* sums, const float* compensators, size_t lanes, float* sum, float* compensator)
+{
+	float running_sum = 0.f;
+	float error = 0.f;
+
+	for (size_t i = 0; i < 2 * lanes; ++i)
+	{
+		const float term = i < lanes ? sums[i] : -compensators[i - lanes];
+		const float temporary_sum = running_sum + term;
+
+		if (fabsf(running_sum) >= fabsf(term))
+		{
+			error += (running_sum - temporary_sum) + term;
+		}
+		else
+		{
+			error += (term - temporary_sum) + running_sum;
+		}
+
+		running_sum = temporary_sum;
+	}
+
+	*sum = running_sum;
+	*compensator = -error;
+}
+
+/// Reduces the vector lanes and sums the elements left over by the vector loop.
+static CompensatedSum FinishKahan(const float* sums, const float* compensators, size_t lanes, const float* tail, size_t tail_length)
+{
+	CompensatedSum result;
+
+	ReduceLanes(sums, compensators, lanes, &result.sum, &result.compensator);
+	KahanContinue(tail, tail_length, &result.sum, &result.compensator);
+
+	return result;
+}
+
+float CompensatedSumValue(CompensatedSum value)
+{
+	return value.sum - value.compensator;
+}
+
+CompensatedSum CombineCompensatedSums(CompensatedSum lhs, CompensatedSum rhs)
+{
+	const float sum = lhs.sum + rhs.sum;
+	const float rhs_part = sum - lhs.sum;
+	const float error = (lhs.sum - (sum - rhs_part)) + (rhs.sum - rhs_part);
+
+	CompensatedSum result;
+	result.sum = sum;
+	result.compensator = (lhs.compensator + rhs.compensator) - error;
+
+	return result;
+}
+
+CompensatedSum KahanSummationScalar(const float* sequence, size_t length)
+{
+	CompensatedSum result = { 0.f, 0.f };
+
+	KahanContinue(sequence, length, &result.sum, &result.compensator);
+
+	return result;
+}
+
+/// Every vector kernel runs four independent accumulators, so that the four dependent
+/// additions of a Kahan step from one accumulator overlap with the others.
+#define ACCUMULATORS 4
+
+TARGET_SSE2 CompensatedSum KahanSummationSse(const float* sequence, size_t length)
+{
+#if CPU_X86
+	enum { LANES = 4, STEP = LANES * ACCUMULATORS };
+
+	__m128 sum[ACCUMULATORS];
+	__m128 compensator[ACCUMULATORS];
+
+	for (int k = 0; k < ACCUMULATORS; ++k)
+	{
+		sum[k] = _mm_setzero_ps();
+		compensator[k] = _mm_setzero_ps();
+	}
+
+	size_t i = 0;
+	for (; i + STEP <= length; i += STEP)
+	{
+		for (int k = 0; k < ACCUMULATORS; ++k)
+		{
+			const __m128 compensated_number = _mm_sub_ps(_mm_loadu_ps(sequence + i + k * LANES), compensator[k]);
+			const __m128 temporary_sum = _mm_add_ps(sum[k], compensated_number);
+
+			compensator[k] = _mm_sub_ps(_mm_sub_ps(temporary_sum, sum[k]), compensated_number);
+			sum[k] = temporary_sum;
+		}
+	}
+
+	float sums[STEP];
+	float compensators[STEP];
+	for (int k = 0; k < ACCUMULATORS; ++k)
+	{
+		_mm_storeu_ps(sums + k * LANES, sum[k]);
+		_mm_storeu_ps(compensators + k * LANES, compensator[k]);
+	}
+
+	return FinishKahan(sums, compensators, STEP, sequence + i, length - i);
+#else
+	return KahanSummationScalar(sequence, length);
+#endif
+}
+
+TARGET_AVX2 CompensatedSum KahanSummationAvx2(const float* sequence, size_t length)
+{
+#if CPU_X86
+	enum { LANES = 8, STEP = LANES * ACCUMULATORS };
+
+	__m256 sum[ACCUMULATORS];
+	__m256 compensator[ACCUMULATORS];
+
+	for (int k = 0; k < ACCUMULATORS; ++k)
+	{
+		sum[k] = _mm256_setzero_ps();
+		compensator[k] = _mm256_setzero_ps();
+	}
+
+	size_t i = 0;
+	for (; i + STEP <= length; i += STEP)
+	{
+		for (int k = 0; k < ACCUMULATORS; ++k)
+		{
+			const __m256 compensated_number = _mm256_sub_ps(_mm256_loadu_ps(sequence + i + k * LANES), compensator[k]);
+			const __m256 temporary_sum = _mm256_add_ps(sum[k], compensated_number);
+
+			compensator[k] = _mm256_sub_ps(_mm256_sub_ps(temporary_sum, sum[k]), compensated_number);
+			sum[k] = temporary_sum;
+		}
+	}
+
+	float sums[STEP];
+	float compensators[STEP];
+	for (int k = 0; k < ACCUMULATORS; ++k)
+	{
+		_mm256_storeu_ps(sums + k * LANES, sum[k]);
+		_mm256_storeu_ps(compensators + k * LANES, compensator[k]);
+	}
+
+	return FinishKahan(sums, compensators, STEP, sequence + i, length - i);
+#else
+	return KahanSummationScalar(sequence, length);
+#endif
+}
+
+TARGET_AVX512 CompensatedSum KahanSummationAvx512(const float* sequence, size_t length)
+{
+#if CPU_X86
+	enum { LANES = 16, STEP = LANES * ACCUMULATORS };
+
+	__m512 sum[ACCUMULATORS];
+	__m512 compensator[ACCUMULATORS];
+
+	for (int k = 0; k < ACCUMULATORS; ++k)
+	{
+		sum[k] = _mm512_setzero_ps();
+		compensator[k] = _mm512_setzero_ps();
+	}
+
+	size_t i = 0;
+	for (; i + STEP <= length; i += STEP)
+	{
+		for (int k = 0; k < ACCUMULATORS; ++k)
+		{
+			const __m512 compensated_number = _mm512_sub_ps(_mm512_loadu_ps(sequence + i + k * LANES), compensator[k]);
+			const __m512 temporary_sum = _mm512_add_ps(sum[k], compensated_number);
+
+			compensator[k] = _mm512_sub_ps(_mm512_sub_ps(temporary_sum, sum[k]), compensated_number);
+			sum[k] = temporary_sum;
+		}
+	}
+
+	float sums[STEP];
+	float compensators[STEP];
+	for (int k = 0; k < ACCUMULATORS; ++k)
+	{
+		_mm512_storeu_ps(sums + k * LANES, sum[k]);
+		_mm512_storeu_ps(compensators + k * LANES, compensator[k]);
+	}
+
+	return FinishKahan(sums, compensators, STEP, sequence + i, length - i);
+#else
+	return KahanSummationScalar(sequence, length);
+#endif
+}
+
+float NeumaierSummation(const float* sequence, size_t length)
+{
+	float sum = 0.f;
+	float error = 0.f;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		const float temporary_sum = sum + sequence[i];
+
+		if (fabsf(sum) >= fabsf(sequence[i]))
+		{
+			error += (sum - temporary_sum) + sequence[i];
+		}
+		else
+		{
+			error += (sequence[i] - temporary_sum) + sum;
+		}
+
+		sum = temporary_sum;
+	}
+
+	return sum + error;
+}
+
+/// Below this length blocks are summed in a plain loop, recursing further only costs calls.
+#define PAIRWISE_BLOCK_LENGTH 128
+
+float PairwiseSummation(const float* sequence, size_t length)
+{
+	if (length <= PAIRWISE_BLOCK_LENGTH)
+	{
+		float sum = 0.f;
+
+		for (size_t i = 0; i < length; ++i)
+		{
+			sum += sequence[i];
+		}
+
+		return sum;
+	}
+
+	const size_t half = length / 2;
+
+	return PairwiseSummation(sequence, half) + PairwiseSummation(sequence + half, length - half);
+}
+
+float DoubleAccumulatorSummation(const float* sequence, size_t length)
+{
+	double sum = 0.0;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		sum += sequence[i];
+	}
+
+	return (float)sum;
+}
+
+SummationKernel SelectKahanSummationKernel(void)
+{
+	const unsigned features = GetCpuFeatures();
+
+	if (features & CPU_FEATURE_AVX512F)
+	{
+		return KahanSummationAvx512;
+	}
+
+	if (features & CPU_FEATURE_AVX2)
+	{
+		return KahanSummationAvx2;
+	}
+
+	if (features & CPU_FEATURE_SSE2)
+	{
+		return KahanSummationSse;
+	}
+
+	return KahanSummationScalar;
+}
+
+const char* KahanSummationKernelName(SummationKernel kernel)
+{
+	if (kernel == KahanSummationAvx512)
+	{
+		return "AVX-512";
+	}
+
+	if (kernel == KahanSummationAvx2)
+	{
+		return "AVX2";
+	}
+
+	if (kernel == KahanSummationSse)
+	{
+		return "SSE";
+	}
+
+	return "scalar";
+}
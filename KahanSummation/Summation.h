@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+
+/// Compensated summation loses its correction term if the compiler may reassociate float additions.
+#if defined(__FAST_MATH__) || defined(_M_FP_FAST)
+#error "Compensated summation must not be built with -ffast-math or /fp:fast"
+#endif
+
+/// Running Kahan state, the value it stands for is sum - compensator.
+typedef struct CompensatedSum
+{
+	float sum;
+	float compensator;
+} CompensatedSum;
+
+typedef CompensatedSum (*SummationKernel)(const float* sequence, size_t length);
+
+float CompensatedSumValue(CompensatedSum value);
+
+/// Adds two partial results with TwoSum, keeping the rounding error of adding the sums.
+CompensatedSum CombineCompensatedSums(CompensatedSum lhs, CompensatedSum rhs);
+
+/// Kahan summation, every kernel keeps its own running sum and compensator per vector lane
+/// and merges the lanes with a compensated reduction at the end.
+CompensatedSum KahanSummationScalar(const float* sequence, size_t length);
+CompensatedSum KahanSummationSse(const float* sequence, size_t length);
+CompensatedSum KahanSummationAvx2(const float* sequence, size_t length);
+CompensatedSum KahanSummationAvx512(const float* sequence, size_t length);
+
+/// Kahan-Babuska: like Kahan, but also exact when an element is larger than the running sum.
+float NeumaierSummation(const float* sequence, size_t length);
+
+/// Sums halves recursively down to short blocks, the error grows with log(length) instead of length.
+float PairwiseSummation(const float* sequence, size_t length);
+
+/// Plain summation into a double, rounded to float at the end.
+float DoubleAccumulatorSummation(const float* sequence, size_t length);
+
+/// Widest of the kernels above the running CPU supports.
+SummationKernel SelectKahanSummationKernel(void);
+const char* KahanSummationKernelName(SummationKernel kernel);
@@ -0,0 +1,133 @@
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "Threads.h"
+
+#include <malloc.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+typedef struct ThreadArguments
+{
+	ParallelRoutine routine;
+	void* context;
+	unsigned thread;
+	unsigned threads_count;
+} ThreadArguments;
+
+#if defined(_WIN32)
+typedef HANDLE ThreadHandle;
+
+static DWORD WINAPI ThreadEntry(LPVOID parameter)
+{
+	const ThreadArguments* arguments = (const ThreadArguments*)parameter;
+	arguments->routine(arguments->context, arguments->thread, arguments->threads_count);
+	return 0;
+}
+
+static int StartThread(ThreadHandle* handle, ThreadArguments* arguments)
+{
+	*handle = CreateThread(NULL, 0, ThreadEntry, arguments, 0, NULL);
+	return *handle != NULL;
+}
+
+static void JoinThread(ThreadHandle handle)
+{
+	WaitForSingleObject(handle, INFINITE);
+	CloseHandle(handle);
+}
+#else
+typedef pthread_t ThreadHandle;
+
+static void* ThreadEntry(void* parameter)
+{
+	const ThreadArguments* arguments = (const ThreadArguments*)parameter;
+	arguments->routine(arguments->context, arguments->thread, arguments->threads_count);
+	return NULL;
+}
+
+static int StartThread(ThreadHandle* handle, ThreadArguments* arguments)
+{
+	return pthread_create(handle, NULL, ThreadEntry, arguments) == 0;
+}
+
+static void JoinThread(ThreadHandle handle)
+{
+	pthread_join(handle, NULL);
+}
+#endif
+
+void RunParallel(ParallelRoutine routine, void* context, unsigned threads_count)
+{
+	ThreadHandle* handles = NULL;
+	ThreadArguments* arguments = NULL;
+
+	if (threads_count > 1)
+	{
+		handles = (ThreadHandle*)malloc(threads_count * sizeof(ThreadHandle));
+		arguments = (ThreadArguments*)malloc(threads_count * sizeof(ThreadArguments));
+	}
+
+	unsigned started = 1;
+	if (handles != NULL && arguments != NULL)
+	{
+		for (; started < threads_count; ++started)
+		{
+			arguments[started].routine = routine;
+			arguments[started].context = context;
+			arguments[started].thread = started;
+			arguments[started].threads_count = threads_count;
+
+			if (!StartThread(&handles[started], &arguments[started]))
+			{
+				break;
+			}
+		}
+	}
+
+	routine(context, 0, threads_count);
+
+	for (unsigned t = started; t < threads_count; ++t)
+	{
+		routine(context, t, threads_count);
+	}
+
+	for (unsigned t = 1; t < started; ++t)
+	{
+		JoinThread(handles[t]);
+	}
+
+	free(handles);
+	free(arguments);
+}
+
+unsigned GetProcessorsCount(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (unsigned)info.dwNumberOfProcessors : 1;
+#else
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (unsigned)count : 1;
+#endif
+}
+
+void SleepMilliseconds(unsigned milliseconds)
+{
+#if defined(_WIN32)
+	Sleep(milliseconds);
+#else
+	struct timespec duration;
+	duration.tv_sec = milliseconds / 1000;
+	duration.tv_nsec = (long)(milliseconds % 1000) * 1000000;
+	nanosleep(&duration, NULL);
+#endif
+}
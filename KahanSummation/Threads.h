@@ -0,0 +1,13 @@
+#pragma once
+
+typedef void (*ParallelRoutine)(void* context, unsigned thread, unsigned threads_count);
+
+/// Calls routine once for every index in [0, threads_count) and returns when all calls finished.
+/// Index 0 runs on the calling thread, the rest on threads started for the call.
+/// Indices whose thread could not be started run on the calling thread as well.
+void RunParallel(ParallelRoutine routine, void* context, unsigned threads_count);
+
+/// Number of logical processors, at least 1.
+unsigned GetProcessorsCount(void);
+
+void SleepMilliseconds(unsigned milliseconds);
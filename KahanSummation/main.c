@@ -1,63 +1,31 @@
 #include <stdio.h>
 #include <malloc.h>
-#include <time.h>
-#include <stdlib.h>
+#include <string.h>
 
-void InitializeRandomGenerator()
-{
-	static int initialized = 0;
-
-	if (initialized == 0)
-	{
-		srand((unsigned)time(NULL));
-
-		initialized = 1;
-	}
-}
-
-void GenerateRandomFloatSequence(float* sequence, size_t length)
-{
-	InitializeRandomGenerator();
-
-	for (size_t i = 0; i < length; ++i)
-	{
-		sequence[i] = ((float)rand() / RAND_MAX) * 1000.f;
-	}
-}
-
-void GenerateIncrementalFloatSequence(float* sequence, size_t length)
-{
-	float base = 0.f;
-	float step = 0.1f;
-
-	for (size_t i = 0; i < length; ++i)
-	{
-		sequence[i] = base + (i * step);
-	}
-}
-
-void GenerateEqualFloatSequence(float* sequence, size_t length)
-{
-	const float VALUE = 0.12345;
-
-	for (size_t i = 0; i < length; ++i)
-	{
-		sequence[i] = VALUE;
-	}
-}
+#include "AccumulatorChecks.h"
+#include "Benchmark.h"
+#include "FileSummation.h"
+#include "Generators.h"
+#include "ParallelSummation.h"
+#include "Summation.h"
+#include "Threads.h"
 
 void GenerateFloatSequence(float** sequence, size_t length)
 {
-	*sequence = (float*)malloc(length * sizeof(float));
+	const unsigned long long SEED = 1;
+
+	*sequence = AllocateFloatSequence(length);
 
 	if (*sequence == NULL)
 	{
 		return;
 	}
 
-	//GenerateRandomFloatSequence(*sequence, length);
-	//GenerateIncrementalFloatSequence(*sequence, length);
-	GenerateEqualFloatSequence(*sequence, length);
+	//GenerateRandomFloatSequence(*sequence, length, SEED);
+	//GenerateIncrementalFloatSequence(*sequence, length, SEED);
+	//GenerateAdversarialFloatSequence(*sequence, length, SEED);
+	//GenerateHeavyTailedFloatSequence(*sequence, length, SEED);
+	GenerateEqualFloatSequence(*sequence, length, SEED);
 }
 
 void PrintSequence(const float* sequence, size_t length)
@@ -87,6 +55,28 @@ float KahanSummation(const float* sequence, size_t length)
 	return sum;
 }
 
+float VectorizedKahanSummation(const float* sequence, size_t length)
+{
+	const SummationKernel kernel = SelectKahanSummationKernel();
+
+	const float sum = CompensatedSumValue(kernel(sequence, length));
+
+	printf("VectorizedKahanSummation (%s): %f\n", KahanSummationKernelName(kernel), sum);
+
+	return sum;
+}
+
+float ParallelKahanSummationOnAllProcessors(const float* sequence, size_t length)
+{
+	const unsigned threads_count = GetProcessorsCount();
+
+	const float sum = CompensatedSumValue(ParallelKahanSummation(sequence, length, threads_count));
+
+	printf("ParallelKahanSummation (%u threads): %f\n", threads_count, sum);
+
+	return sum;
+}
+
 float NaiveSummation(const float* sequence, size_t length)
 {
 	float sum = 0.f;
@@ -101,8 +91,83 @@ float NaiveSummation(const float* sequence, size_t length)
 	return sum;
 }
 
-int main()
+int SumFile(const char* path)
+{
+	CompensatedSum sum;
+
+	if (!SumFloatFile(path, &sum))
+	{
+		printf("Could not read %s\n", path);
+		return 1;
+	}
+
+	printf("FileSummation: %f\n", CompensatedSumValue(sum));
+
+	return 0;
+}
+
+/// Sums the file as it grows, printing the running sum whenever floats were appended. Runs until killed.
+int FollowFile(const char* path)
 {
+	const unsigned POLL_MILLISECONDS = 500;
+
+	FloatFileFollower* follower = OpenFloatFileFollower(path);
+	if (follower == NULL)
+	{
+		printf("Could not open %s\n", path);
+		return 1;
+	}
+
+	unsigned long long reported = 0;
+
+	for (;;)
+	{
+		if (!FollowFloatFile(follower))
+		{
+			printf("Could not read %s\n", path);
+			CloseFloatFileFollower(follower);
+			return 1;
+		}
+
+		if (FloatFileFollowerCount(follower) != reported)
+		{
+			reported = FloatFileFollowerCount(follower);
+			printf("FileSummation (%llu floats): %f\n", reported, CompensatedSumValue(FloatFileFollowerSum(follower)));
+			fflush(stdout);
+		}
+
+		SleepMilliseconds(POLL_MILLISECONDS);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+	{
+		RunSummationBenchmark();
+
+		return 0;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--check") == 0)
+	{
+		const unsigned failures = RunAccumulatorChecks();
+
+		printf("%u accumulator checks failed\n", failures);
+
+		return failures == 0 ? 0 : 1;
+	}
+
+	if (argc > 2 && strcmp(argv[1], "--file") == 0)
+	{
+		return SumFile(argv[2]);
+	}
+
+	if (argc > 2 && strcmp(argv[1], "--follow") == 0)
+	{
+		return FollowFile(argv[2]);
+	}
+
 	const size_t DEFAULT_SEQUENCE_LENGTH = 500000;
 
 	float* sequence = NULL;
@@ -118,9 +183,11 @@ int main()
 	//PrintSequence(sequence, length);
 
 	KahanSummation(sequence, length);
+	VectorizedKahanSummation(sequence, length);
+	ParallelKahanSummationOnAllProcessors(sequence, length);
 	NaiveSummation(sequence, length);
 
-	free(sequence);
+	FreeFloatSequence(sequence);
 
 	return 0;
 }
\ No newline at end of file